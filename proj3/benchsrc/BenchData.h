@@ -0,0 +1,29 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+// reads a data file once and keeps it in memory, so benchmarks measure parsing rather than disk access, a
+// missing file aborts the run instead of timing empty input
+inline const std::string &BenchFile(const std::string &path){
+    static std::unordered_map< std::string, std::string > Files;
+    auto Search = Files.find(path);
+    if(Search == Files.end()){
+        std::ifstream Input(path, std::ios::binary);
+        if(!Input.is_open()){
+            std::fprintf(stderr, "unable to open benchmark data %s, run from the project directory\n", path.c_str());
+            std::exit(1);
+        }
+        std::stringstream Buffer;
+        Buffer << Input.rdbuf();
+        Search = Files.emplace(path, Buffer.str()).first;
+    }
+    return Search->second;
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "CSVBusSystem.h"
+#include "DSVTable.h"
+#include "IDIndex.h"
+#include "StringDataSource.h"
+
+static void BM_CSVBusSystemLoad(benchmark::State &state){
+    const std::string &Stops = BenchFile("data/stops.csv");
+    const std::string &Routes = BenchFile("data/routes.csv");
+    int64_t Rows = 0;
+    for(auto _ : state){
+        CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Stops), ','),
+                                std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Routes), ','));
+        Rows += BusSystem.StopCount();
+        for(std::size_t Index = 0; Index < BusSystem.RouteCount(); Index++){
+            Rows += BusSystem.RouteByIndex(Index)->StopCount();
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * (Stops.size() + Routes.size()));
+    state.counters["rows/s"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CSVBusSystemLoad);
+
+// the same files as typed columns, loading both (0) or the stops alone (1)
+static void BM_DSVTableLoad(benchmark::State &state){
+    const std::string &Stops = BenchFile("data/stops.csv");
+    const std::string &Routes = BenchFile("data/routes.csv");
+    int64_t Rows = 0;
+    for(auto _ : state){
+        CDSVTable StopTable(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Stops), ','));
+        Rows += StopTable.RowCount();
+        if(!state.range(0)){
+            CDSVTable RouteTable(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Routes), ','));
+            Rows += RouteTable.RowCount();
+        }
+    }
+    state.counters["rows/s"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DSVTableLoad)->Arg(0)->Arg(1);
+
+// node of every stop of every route, through the bus system objects and through table columns
+static void BM_CSVBusSystemStopNodeJoin(benchmark::State &state){
+    CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(BenchFile("data/stops.csv")), ','),
+                            std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(BenchFile("data/routes.csv")), ','));
+    int64_t Joined = 0;
+    for(auto _ : state){
+        uint64_t Sum = 0;
+        for(std::size_t Route = 0; Route < BusSystem.RouteCount(); Route++){
+            auto Handle = BusSystem.RouteHandleByIndex(Route);
+            for(std::size_t Stop = 0; Stop < Handle->StopCount(); Stop++){
+                auto StopHandle = BusSystem.StopHandleByID(Handle->GetStopID(Stop));
+                Sum += StopHandle ? StopHandle->NodeID() : 0;
+                Joined++;
+            }
+        }
+        benchmark::DoNotOptimize(Sum);
+    }
+    state.counters["rows/s"] = benchmark::Counter(Joined, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CSVBusSystemStopNodeJoin);
+
+static void BM_DSVTableStopNodeJoin(benchmark::State &state){
+    CDSVTable Stops(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(BenchFile("data/stops.csv")), ','));
+    CDSVTable Routes(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(BenchFile("data/routes.csv")), ','));
+    auto StopIDs = reinterpret_cast<const uint64_t *>(Stops.Int64Column(Stops.ColumnIndex("stop_id")));
+    auto NodeIDs = Stops.Int64Column(Stops.ColumnIndex("node_id"));
+    auto RouteStops = reinterpret_cast<const uint64_t *>(Routes.Int64Column(Routes.ColumnIndex("stop_id")));
+    CIDIndex Index;
+    Index.Build(StopIDs, Stops.RowCount());
+    std::vector< std::size_t > Positions(Routes.RowCount());
+    int64_t Joined = 0;
+    for(auto _ : state){
+        Index.Find(RouteStops, Routes.RowCount(), Positions.data());
+        uint64_t Sum = 0;
+        for(auto Position : Positions){
+            Sum += Position == CIDIndex::NotFound ? 0 : NodeIDs[Position];
+        }
+        Joined += Positions.size();
+        benchmark::DoNotOptimize(Sum);
+    }
+    state.counters["rows/s"] = benchmark::Counter(Joined, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DSVTableStopNodeJoin);
@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "DSVReader.h"
+#include "DSVWriter.h"
+#include "DSVRowIndex.h"
+#include "DSVDialect.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <random>
+
+static void BM_DSVReadRow(benchmark::State &state){
+    const std::string &Data = BenchFile("data/routes.csv");
+    std::vector< std::string > Row;
+    int64_t Rows = 0;
+    for(auto _ : state){
+        CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',');
+        while(Reader.ReadRow(Row)){
+            Rows++;
+        }
+        benchmark::DoNotOptimize(Row);
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows/s"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DSVReadRow);
+
+static void BM_DSVWriteRow(benchmark::State &state){
+    std::vector< std::vector< std::string > > Rows;
+    CDSVReader Reader(std::make_shared<CStringDataSource>(BenchFile("data/routes.csv")), ',');
+    std::vector< std::string > Row;
+    std::size_t Bytes = 0;
+    while(Reader.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    for(auto _ : state){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CDSVWriter Writer(Sink, ',');
+        for(auto &Output : Rows){
+            Writer.WriteRow(Output);
+        }
+        Bytes += Sink->String().size();
+    }
+    state.SetBytesProcessed(Bytes);
+    state.counters["rows/s"] = benchmark::Counter(state.iterations() * Rows.size(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DSVWriteRow);
+
+// a wide export where only 2 of 40 columns are wanted
+static const std::string &WideData(){
+    static std::string Data;
+    if(Data.empty()){
+        for(int Column = 0; Column < 40; Column++){
+            Data += (Column ? ",column" : "column") + std::to_string(Column);
+        }
+        Data += "\n";
+        for(int Line = 0; Line < 10000; Line++){
+            for(int Column = 0; Column < 40; Column++){
+                Data += (Column ? ",value " : "value ") + std::to_string(Line * 40 + Column);
+            }
+            Data += "\n";
+        }
+    }
+    return Data;
+}
+
+// read whole (0) or through a header projection (1)
+static void BM_DSVReadWide(benchmark::State &state){
+    const std::string &Data = WideData();
+    std::vector< std::string > Row;
+    int64_t Rows = 0;
+    for(auto _ : state){
+        CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',');
+        if(state.range(0)){
+            Reader.ReadHeader({"column3", "column17"});
+        }
+        else{
+            Reader.ReadRow(Row);
+        }
+        while(Reader.ReadRow(Row)){
+            Rows++;
+        }
+        benchmark::DoNotOptimize(Row);
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows/s"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DSVReadWide)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// a large stop dump, one random row fetched by parsing from the start (0) or through a row index (1)
+static const std::string &LargeStops(){
+    static std::string Data;
+    if(Data.empty()){
+        Data = "stop_id,node_id\n";
+        for(int Stop = 0; Stop < 200000; Stop++){
+            Data += std::to_string(Stop) + "," + std::to_string(Stop * 7919ULL) + "\n";
+        }
+    }
+    return Data;
+}
+
+static void BM_DSVFetchRow(benchmark::State &state){
+    auto Source = std::make_shared<CStringDataSource>(LargeStops());
+    auto Index = std::make_shared<CDSVRowIndex>();
+    Index->Build(*Source);
+    CIndexedDSVReader Indexed(Source, ',', Index);
+    std::mt19937 Generator(45);
+    std::vector< std::string > Row;
+    for(auto _ : state){
+        std::size_t Target = Generator() % Index->RowCount();
+        if(state.range(0)){
+            Indexed.SeekRow(Target);
+            Indexed.ReadRow(Row);
+        }
+        else{
+            CDSVReader Reader(std::make_shared<CStringDataSource>(LargeStops()), ',');
+            for(std::size_t Skip = 0; Skip <= Target; Skip++){
+                Reader.ReadRow(Row);
+            }
+        }
+        benchmark::DoNotOptimize(Row);
+    }
+}
+BENCHMARK(BM_DSVFetchRow)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+static void BM_DSVRowIndexBuild(benchmark::State &state){
+    CStringDataSource Source(LargeStops());
+    for(auto _ : state){
+        CDSVRowIndex Index;
+        Index.Build(Source);
+        benchmark::DoNotOptimize(Index.RowCount());
+    }
+    state.SetBytesProcessed(state.iterations() * LargeStops().size());
+}
+BENCHMARK(BM_DSVRowIndexBuild)->Unit(benchmark::kMillisecond);
+
+// the same files through the compile time csv dialect, routes.csv (0) and the wide export read whole (1)
+static void BM_DSVDialectReadRow(benchmark::State &state){
+    const std::string &Data = state.range(0) ? WideData() : BenchFile("data/routes.csv");
+    std::vector< std::string > Row;
+    int64_t Rows = 0;
+    for(auto _ : state){
+        CDSVDialectReader<SCSVDialect> Reader(std::make_shared<CStringDataSource>(Data));
+        while(Reader.ReadRow(Row)){
+            Rows++;
+        }
+        benchmark::DoNotOptimize(Row);
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows/s"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DSVDialectReadRow)->Arg(0)->Arg(1);
+
+static void BM_DSVDialectWriteRow(benchmark::State &state){
+    std::vector< std::vector< std::string > > Rows;
+    CDSVReader Reader(std::make_shared<CStringDataSource>(BenchFile("data/routes.csv")), ',');
+    std::vector< std::string > Row;
+    std::size_t Bytes = 0;
+    while(Reader.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    for(auto _ : state){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CDSVDialectWriter<SCSVDialect> Writer(Sink);
+        for(auto &Output : Rows){
+            Writer.WriteRow(Output);
+        }
+        Bytes += Sink->String().size();
+    }
+    state.SetBytesProcessed(Bytes);
+    state.counters["rows/s"] = benchmark::Counter(state.iterations() * Rows.size(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DSVDialectWriteRow);
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "GeographicUtils.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "StopDistanceMatrix.h"
+#include "StringDataSource.h"
+
+// node locations of davis.osm in both forms and the consecutive node pairs of its ways, gathered once
+struct SGeographicData{
+    std::shared_ptr<COpenStreetMap> DStreetMap;
+    std::vector< CStreetMap::TLocation > DLocations;
+    std::vector< SFixedLocation > DFixedLocations;
+    std::vector< uint32_t > DSources;
+    std::vector< uint32_t > DTargets;
+};
+
+static const SGeographicData &DavisData(){
+    static SGeographicData Data;
+    if(!Data.DStreetMap){
+        Data.DStreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(BenchFile("data/davis.osm"))));
+        for(std::size_t Index = 0; Index < Data.DStreetMap->NodeCount(); Index++){
+            Data.DLocations.push_back(Data.DStreetMap->NodeHandleByIndex(Index)->Location());
+            Data.DFixedLocations.push_back(GeographicUtils::ToFixed(Data.DLocations.back()));
+        }
+        std::vector< std::size_t > Offsets, Indices;
+        Data.DStreetMap->ResolveWayNodes(Offsets, Indices);
+        for(std::size_t Way = 0; Way + 1 < Offsets.size(); Way++){
+            for(std::size_t Index = Offsets[Way] + 1; Index < Offsets[Way + 1]; Index++){
+                if(Indices[Index - 1] < Data.DLocations.size() && Indices[Index] < Data.DLocations.size()){
+                    Data.DSources.push_back(uint32_t(Indices[Index - 1]));
+                    Data.DTargets.push_back(uint32_t(Indices[Index]));
+                }
+            }
+        }
+    }
+    return Data;
+}
+
+static const CStreetMap::TLocation Origin(38.5449, -121.7405);
+
+static void BM_HaversineScalar(benchmark::State &state){
+    const auto &Data = DavisData();
+    std::vector< double > Results(Data.DLocations.size());
+    for(auto _ : state){
+        for(std::size_t Index = 0; Index < Data.DLocations.size(); Index++){
+            Results[Index] = GeographicUtils::HaversineDistance(Origin, Data.DLocations[Index]);
+        }
+        benchmark::DoNotOptimize(Results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Data.DLocations.size());
+}
+BENCHMARK(BM_HaversineScalar);
+
+// 0 reads double locations, 1 reads fixed point locations
+static void BM_HaversineBatch(benchmark::State &state){
+    const auto &Data = DavisData();
+    std::vector< double > Results(Data.DLocations.size());
+    for(auto _ : state){
+        if(state.range(0)){
+            GeographicUtils::HaversineDistances(Origin, Data.DFixedLocations.data(), Data.DFixedLocations.size(), Results.data());
+        }
+        else{
+            GeographicUtils::HaversineDistances(Origin, Data.DLocations.data(), Data.DLocations.size(), Results.data());
+        }
+        benchmark::DoNotOptimize(Results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Data.DLocations.size());
+}
+BENCHMARK(BM_HaversineBatch)->Arg(0)->Arg(1);
+
+static void BM_EquirectangularBatch(benchmark::State &state){
+    const auto &Data = DavisData();
+    std::vector< double > Results(Data.DLocations.size());
+    for(auto _ : state){
+        if(state.range(0)){
+            GeographicUtils::EquirectangularDistances(Origin, Data.DFixedLocations.data(), Data.DFixedLocations.size(), Results.data());
+        }
+        else{
+            GeographicUtils::EquirectangularDistances(Origin, Data.DLocations.data(), Data.DLocations.size(), Results.data());
+        }
+        benchmark::DoNotOptimize(Results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Data.DLocations.size());
+}
+BENCHMARK(BM_EquirectangularBatch)->Arg(0)->Arg(1);
+
+static void BM_BearingBatch(benchmark::State &state){
+    const auto &Data = DavisData();
+    std::vector< double > Results(Data.DLocations.size());
+    for(auto _ : state){
+        if(state.range(0)){
+            GeographicUtils::Bearings(Origin, Data.DFixedLocations.data(), Data.DFixedLocations.size(), Results.data());
+        }
+        else{
+            GeographicUtils::Bearings(Origin, Data.DLocations.data(), Data.DLocations.size(), Results.data());
+        }
+        benchmark::DoNotOptimize(Results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Data.DLocations.size());
+}
+BENCHMARK(BM_BearingBatch)->Arg(0)->Arg(1);
+
+// edge weights of every way segment, 0 one scalar call per pair, 1 the indexed pair kernel
+static void BM_HaversineEdges(benchmark::State &state){
+    const auto &Data = DavisData();
+    std::vector< double > Results(Data.DSources.size());
+    for(auto _ : state){
+        if(state.range(0)){
+            GeographicUtils::HaversineDistances(Data.DFixedLocations.data(), Data.DFixedLocations.size(), Data.DSources.data(), Data.DTargets.data(), Data.DSources.size(), Results.data());
+        }
+        else{
+            for(std::size_t Index = 0; Index < Data.DSources.size(); Index++){
+                Results[Index] = GeographicUtils::HaversineDistance(Data.DLocations[Data.DSources[Index]], Data.DLocations[Data.DTargets[Index]]);
+            }
+        }
+        benchmark::DoNotOptimize(Results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Data.DSources.size());
+}
+BENCHMARK(BM_HaversineEdges)->Arg(0)->Arg(1);
+
+// graph building and stop binding, the part of the matrix the edge kernel feeds
+static void BM_StopDistanceMatrixBuild(benchmark::State &state){
+    const auto &Data = DavisData();
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(BenchFile("data/stops.csv")), ','),
+                                                     std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(BenchFile("data/routes.csv")), ','));
+    for(auto _ : state){
+        CStopDistanceMatrix Matrix(Data.DStreetMap, BusSystem);
+        benchmark::DoNotOptimize(Matrix.StopCount());
+    }
+}
+BENCHMARK(BM_StopDistanceMatrixBuild)->Unit(benchmark::kMillisecond);
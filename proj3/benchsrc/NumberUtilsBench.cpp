@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "NumberUtils.h"
+#include "DSVReader.h"
+#include "XMLReader.h"
+#include "StringDataSource.h"
+
+// the numeric attribute values of davis.osm and the cells of stops.csv, gathered once so only conversion is timed
+struct SNumberFields{
+    std::vector< std::string > DIntegers;
+    std::vector< std::string > DDecimals;
+};
+
+static const SNumberFields &OSMFields(){
+    static SNumberFields Fields;
+    if(Fields.DIntegers.empty()){
+        CXMLReader Reader(std::make_shared<CStringDataSource>(BenchFile("data/davis.osm")));
+        SXMLEntity Entity;
+        while(Reader.ReadEntity(Entity)){
+            for(auto &Attribute : Entity.DAttributes){
+                if(Attribute.first == "id" || Attribute.first == "ref"){
+                    Fields.DIntegers.push_back(Attribute.second);
+                }
+                else if(Attribute.first == "lat" || Attribute.first == "lon"){
+                    Fields.DDecimals.push_back(Attribute.second);
+                }
+            }
+        }
+    }
+    return Fields;
+}
+
+static const SNumberFields &StopFields(){
+    static SNumberFields Fields;
+    if(Fields.DIntegers.empty()){
+        CDSVReader Reader(std::make_shared<CStringDataSource>(BenchFile("data/stops.csv")), ',');
+        std::vector< std::string > Row;
+        while(Reader.ReadRow(Row)){
+            Fields.DIntegers.insert(Fields.DIntegers.end(), Row.begin(), Row.end());
+        }
+    }
+    return Fields;
+}
+
+// what the loaders did before, exceptions on bad values included, the stops.csv header throws every pass
+static void ConvertStandard(const SNumberFields &fields, benchmark::State &state){
+    uint64_t IntegerSum = 0;
+    double DecimalSum = 0.0;
+    for(auto _ : state){
+        for(auto &Field : fields.DIntegers){
+            try{
+                IntegerSum += std::stoull(Field);
+            }
+            catch(const std::exception &){
+            }
+        }
+        for(auto &Field : fields.DDecimals){
+            DecimalSum += std::stod(Field);
+        }
+    }
+    benchmark::DoNotOptimize(IntegerSum);
+    benchmark::DoNotOptimize(DecimalSum);
+    state.SetItemsProcessed(state.iterations() * (fields.DIntegers.size() + fields.DDecimals.size()));
+}
+
+static void ConvertNumberUtils(const SNumberFields &fields, benchmark::State &state){
+    uint64_t IntegerSum = 0;
+    double DecimalSum = 0.0;
+    SParseErrors Errors;
+    for(auto _ : state){
+        for(auto &Field : fields.DIntegers){
+            uint64_t Value = 0;
+            NumberUtils::ToUInt64(Field, Value, &Errors);
+            IntegerSum += Value;
+        }
+        for(auto &Field : fields.DDecimals){
+            double Value = 0.0;
+            NumberUtils::ToDouble(Field, Value, &Errors);
+            DecimalSum += Value;
+        }
+    }
+    benchmark::DoNotOptimize(IntegerSum);
+    benchmark::DoNotOptimize(DecimalSum);
+    state.SetItemsProcessed(state.iterations() * (fields.DIntegers.size() + fields.DDecimals.size()));
+}
+
+static void BM_NumberOSMStandard(benchmark::State &state){
+    ConvertStandard(OSMFields(), state);
+}
+BENCHMARK(BM_NumberOSMStandard)->Unit(benchmark::kMicrosecond);
+
+static void BM_NumberOSMNumberUtils(benchmark::State &state){
+    ConvertNumberUtils(OSMFields(), state);
+}
+BENCHMARK(BM_NumberOSMNumberUtils)->Unit(benchmark::kMicrosecond);
+
+static void BM_NumberStopsStandard(benchmark::State &state){
+    ConvertStandard(StopFields(), state);
+}
+BENCHMARK(BM_NumberStopsStandard)->Unit(benchmark::kMicrosecond);
+
+static void BM_NumberStopsNumberUtils(benchmark::State &state){
+    ConvertNumberUtils(StopFields(), state);
+}
+BENCHMARK(BM_NumberStopsNumberUtils)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,405 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "OpenStreetMap.h"
+#include "LazyOpenStreetMap.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include "SyntheticMapGenerator.h"
+#include "IDIndex.h"
+#include "GeographicUtils.h"
+#include <queue>
+#include <algorithm>
+#include <map>
+#include <random>
+
+static std::shared_ptr<COpenStreetMap> LoadDavis(){
+    return std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(BenchFile("data/davis.osm"))));
+}
+
+static void BM_OpenStreetMapLoad(benchmark::State &state){
+    const std::string &Data = BenchFile("data/davis.osm");
+    int64_t Elements = 0;
+    for(auto _ : state){
+        auto StreetMap = LoadDavis();
+        Elements += StreetMap->NodeCount() + StreetMap->WayCount();
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities/s"] = benchmark::Counter(Elements, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_OpenStreetMapLoad)->Unit(benchmark::kMillisecond);
+
+static void BM_OpenStreetMapDestroy(benchmark::State &state){
+    for(auto _ : state){
+        state.PauseTiming();
+        auto StreetMap = LoadDavis();
+        state.ResumeTiming();
+        StreetMap.reset();
+    }
+}
+BENCHMARK(BM_OpenStreetMapDestroy)->Unit(benchmark::kMillisecond);
+
+// compare with BM_OpenStreetMapLoad for the cost of instrumentation, the counters break the load down by phase
+static void BM_OpenStreetMapLoadStats(benchmark::State &state){
+    const std::string &Data = BenchFile("data/davis.osm");
+    SLoadStats Stats;
+    for(auto _ : state){
+        COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)), &Stats);
+    }
+    double Iterations = state.iterations();
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["io_ms"] = Stats.DIOSeconds * 1000.0 / Iterations;
+    state.counters["tokenize_ms"] = Stats.DTokenizeSeconds * 1000.0 / Iterations;
+    state.counters["build_ms"] = Stats.DBuildSeconds * 1000.0 / Iterations;
+    state.counters["allocs"] = Stats.DAllocationCount / Iterations;
+}
+BENCHMARK(BM_OpenStreetMapLoadStats)->Unit(benchmark::kMillisecond);
+
+// highway ways with their nodes and two tag keys, the usual shape of a routing load
+static void BM_OpenStreetMapLoadFiltered(benchmark::State &state){
+    const std::string &Data = BenchFile("data/davis.osm");
+    COpenStreetMap::SLoadOptions Options;
+    Options.DTagKeys = {"highway", "name"};
+    Options.DWayFilter = [](const std::vector< COpenStreetMap::SLoadOptions::TTag > &tags){
+        for(auto &Tag : tags){
+            if(Tag.first == "highway"){
+                return true;
+            }
+        }
+        return false;
+    };
+    Options.DReferencedNodesOnly = true;
+    SLoadStats Stats;
+    for(auto _ : state){
+        COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)), Options, &Stats);
+    }
+    double Iterations = state.iterations();
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["nodes"] = Stats.DNodeCount / Iterations;
+    state.counters["ways"] = Stats.DWayCount / Iterations;
+    state.counters["allocs"] = Stats.DAllocationCount / Iterations;
+}
+BENCHMARK(BM_OpenStreetMapLoadFiltered)->Unit(benchmark::kMillisecond);
+
+// a small box in the middle of town, the nodes outside it are skipped without building their tags
+static void BM_OpenStreetMapLoadBounds(benchmark::State &state){
+    const std::string &Data = BenchFile("data/davis.osm");
+    COpenStreetMap::SLoadOptions Options;
+    Options.DUseBounds = true;
+    Options.DLowerLeft = {38.54, -121.75};
+    Options.DUpperRight = {38.56, -121.73};
+    SLoadStats Stats;
+    for(auto _ : state){
+        COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)), Options, &Stats);
+    }
+    double Iterations = state.iterations();
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["nodes"] = Stats.DNodeCount / Iterations;
+    state.counters["ways"] = Stats.DWayCount / Iterations;
+    state.counters["allocs"] = Stats.DAllocationCount / Iterations;
+}
+BENCHMARK(BM_OpenStreetMapLoadBounds)->Unit(benchmark::kMillisecond);
+
+// same load over generated maps, to see how it scales past the size of the davis extract
+static void BM_OpenStreetMapLoadSynthetic(benchmark::State &state){
+    auto Sink = std::make_shared<CStringDataSink>();
+    CSyntheticMapGenerator(state.range(0)).WriteOSM(Sink);
+    const std::string &Data = Sink->String();
+    int64_t Elements = 0;
+    for(auto _ : state){
+        COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)));
+        Elements += StreetMap.NodeCount() + StreetMap.WayCount();
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities/s"] = benchmark::Counter(Elements, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_OpenStreetMapLoadSynthetic)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_OpenStreetMapNodeByID(benchmark::State &state){
+    auto StreetMap = LoadDavis();
+    std::vector< CStreetMap::TNodeID > IDs;
+    std::mt19937 Generator(34);
+    for(int Index = 0; Index < 1024; Index++){
+        IDs.push_back(StreetMap->NodeByIndex(Generator() % StreetMap->NodeCount())->ID());
+    }
+    std::size_t Next = 0;
+    for(auto _ : state){
+        benchmark::DoNotOptimize(StreetMap->NodeByID(IDs[Next++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OpenStreetMapNodeByID);
+
+// every thread reads the same few hot nodes, where shared_ptr copies contend on the reference counts
+static std::shared_ptr<COpenStreetMap> HotMap;
+
+static void BM_OpenStreetMapHotNodeShared(benchmark::State &state){
+    if(state.thread_index() == 0){
+        HotMap = LoadDavis();
+    }
+    double Sum = 0.0;
+    std::size_t Next = 0;
+    for(auto _ : state){
+        Sum += HotMap->NodeByIndex(Next++ & 7)->Location().first;
+    }
+    benchmark::DoNotOptimize(Sum);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OpenStreetMapHotNodeShared)->Threads(1)->Threads(4);
+
+static void BM_OpenStreetMapHotNodeHandle(benchmark::State &state){
+    if(state.thread_index() == 0){
+        HotMap = LoadDavis();
+    }
+    double Sum = 0.0;
+    std::size_t Next = 0;
+    for(auto _ : state){
+        Sum += HotMap->NodeHandleByIndex(Next++ & 7)->Location().first;
+    }
+    benchmark::DoNotOptimize(Sum);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OpenStreetMapHotNodeHandle)->Threads(1)->Threads(4);
+
+// random ids out of a million, looked up one at a time (0), probed with prefetch (1), sorted and merged (2),
+// or already sorted and probed (3) or merged (4)
+static void BM_IDIndexFind(benchmark::State &state){
+    std::mt19937_64 Generator(42);
+    std::vector< uint64_t > IDs(1000000);
+    for(auto &ID : IDs){
+        ID = Generator() >> 20;
+    }
+    CIDIndex Index;
+    Index.Build(IDs.data(), IDs.size());
+    std::vector< uint64_t > Queries(state.range(0));
+    for(auto &Query : Queries){
+        Query = IDs[Generator() % IDs.size()];
+    }
+    if(state.range(1) >= 3){
+        std::sort(Queries.begin(), Queries.end());
+    }
+    std::vector< std::size_t > Positions(Queries.size());
+    for(auto _ : state){
+        if(state.range(1) == 0){
+            for(std::size_t Query = 0; Query < Queries.size(); Query++){
+                Positions[Query] = Index.Find(Queries[Query]);
+            }
+        }
+        else if(state.range(1) == 1 || state.range(1) == 3){
+            Index.FindProbed(Queries.data(), Queries.size(), Positions.data());
+        }
+        else{
+            Index.FindMerged(Queries.data(), Queries.size(), Positions.data());
+        }
+        benchmark::DoNotOptimize(Positions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Queries.size());
+}
+BENCHMARK(BM_IDIndexFind)->ArgsProduct({{64, 4096, 262144, 1000000}, {0, 1, 2, 3, 4}});
+
+// every nd ref of every way, one lookup per ref against the single bulk resolve
+static void BM_OpenStreetMapWayNodesSingle(benchmark::State &state){
+    auto StreetMap = LoadDavis();
+    std::size_t Refs = 0;
+    for(auto _ : state){
+        for(std::size_t Way = 0; Way < StreetMap->WayCount(); Way++){
+            auto Handle = StreetMap->WayHandleByIndex(Way);
+            for(std::size_t Node = 0; Node < Handle->NodeCount(); Node++){
+                benchmark::DoNotOptimize(StreetMap->NodeHandleByID(Handle->GetNodeID(Node)));
+                Refs++;
+            }
+        }
+    }
+    state.SetItemsProcessed(Refs);
+}
+BENCHMARK(BM_OpenStreetMapWayNodesSingle)->Unit(benchmark::kMicrosecond);
+
+static void BM_OpenStreetMapWayNodesBulk(benchmark::State &state){
+    auto StreetMap = LoadDavis();
+    std::vector< std::size_t > Offsets, Indices;
+    for(auto _ : state){
+        StreetMap->ResolveWayNodes(Offsets, Indices);
+        benchmark::DoNotOptimize(Indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Indices.size());
+}
+BENCHMARK(BM_OpenStreetMapWayNodesBulk)->Unit(benchmark::kMicrosecond);
+
+// start up cost of the lazy map is only the index scan
+static void BM_LazyOpenStreetMapLoad(benchmark::State &state){
+    const std::string &Data = BenchFile("data/davis.osm");
+    int64_t Elements = 0;
+    for(auto _ : state){
+        CLazyOpenStreetMap StreetMap(std::make_shared<CStringDataSource>(Data));
+        Elements += StreetMap.NodeCount() + StreetMap.WayCount();
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities/s"] = benchmark::Counter(Elements, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_LazyOpenStreetMapLoad)->Unit(benchmark::kMillisecond);
+
+// random lookups with a cache far smaller than the map, so most of them decode
+static void BM_LazyOpenStreetMapNodeByID(benchmark::State &state){
+    CLazyOpenStreetMap StreetMap(std::make_shared<CStringDataSource>(BenchFile("data/davis.osm")), state.range(0));
+    std::vector< CStreetMap::TNodeID > IDs;
+    std::mt19937 Generator(34);
+    for(int Index = 0; Index < 1024; Index++){
+        IDs.push_back(StreetMap.NodeByIndex(Generator() % StreetMap.NodeCount())->ID());
+    }
+    std::size_t Next = 0;
+    for(auto _ : state){
+        benchmark::DoNotOptimize(StreetMap.NodeByID(IDs[Next++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LazyOpenStreetMapNodeByID)->Arg(64)->Arg(4096);
+
+// davis (0) or a generated grid city (1), in file order (0) or along the hilbert curve (1), loaded once each
+static std::shared_ptr<COpenStreetMap> OrderedMap(int64_t source, int64_t spatial){
+    static std::map< std::pair< int64_t, int64_t >, std::shared_ptr<COpenStreetMap> > Maps;
+    auto &Map = Maps[{source, spatial}];
+    if(!Map){
+        COpenStreetMap::SLoadOptions Options;
+        Options.DSpatialOrder = spatial;
+        std::string Data = BenchFile("data/davis.osm");
+        if(source){
+            auto Sink = std::make_shared<CStringDataSink>();
+            CSyntheticMapGenerator(250000).WriteOSM(Sink);
+            Data = Sink->String();
+        }
+        Map = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)), Options);
+    }
+    return Map;
+}
+
+// two way edges between consecutive way nodes over node indices, the shape a router builds
+struct SStreetGraph{
+    std::vector< std::size_t > DOffsets;
+    std::vector< std::size_t > DTargets;
+};
+
+static SStreetGraph BuildStreetGraph(const COpenStreetMap &streetmap){
+    std::vector< std::size_t > WayOffsets, Indices;
+    streetmap.ResolveWayNodes(WayOffsets, Indices);
+    std::vector< std::pair< std::size_t, std::size_t > > Edges;
+    for(std::size_t Way = 0; Way + 1 < WayOffsets.size(); Way++){
+        for(std::size_t Index = WayOffsets[Way] + 1; Index < WayOffsets[Way + 1]; Index++){
+            if(Indices[Index - 1] < streetmap.NodeCount() && Indices[Index] < streetmap.NodeCount()){
+                Edges.emplace_back(Indices[Index - 1], Indices[Index]);
+                Edges.emplace_back(Indices[Index], Indices[Index - 1]);
+            }
+        }
+    }
+    std::sort(Edges.begin(), Edges.end());
+    SStreetGraph Graph;
+    Graph.DOffsets.assign(streetmap.NodeCount() + 1, 0);
+    for(auto &Edge : Edges){
+        Graph.DOffsets[Edge.first + 1]++;
+        Graph.DTargets.push_back(Edge.second);
+    }
+    for(std::size_t Index = 0; Index < streetmap.NodeCount(); Index++){
+        Graph.DOffsets[Index + 1] += Graph.DOffsets[Index];
+    }
+    return Graph;
+}
+
+// full searches from the same eight source ids, edge weights come from the node locations as they are relaxed,
+// index_gap is the mean index distance across an edge, a stand in for how far apart in memory neighbours are
+static void BM_OpenStreetMapDijkstra(benchmark::State &state){
+    auto StreetMap = OrderedMap(state.range(0), state.range(1));
+    auto FileOrder = OrderedMap(state.range(0), 0);
+    SStreetGraph Graph = BuildStreetGraph(*StreetMap);
+    std::vector< std::size_t > Sources;
+    for(std::size_t Source = 0; Source < 8; Source++){
+        CStreetMap::TNodeID ID = FileOrder->NodeHandleByIndex(Source * FileOrder->NodeCount() / 8)->ID();
+        std::size_t Index;
+        StreetMap->NodeIndicesByID(&ID, 1, &Index);
+        Sources.push_back(Index);
+    }
+    double Gap = 0.0;
+    for(std::size_t Node = 0; Node < StreetMap->NodeCount(); Node++){
+        for(std::size_t Edge = Graph.DOffsets[Node]; Edge < Graph.DOffsets[Node + 1]; Edge++){
+            Gap += std::abs(double(Graph.DTargets[Edge]) - double(Node));
+        }
+    }
+    std::vector< double > Distances(StreetMap->NodeCount());
+    using TQueueEntry = std::pair< double, std::size_t >;
+    std::size_t Settled = 0;
+    for(auto _ : state){
+        for(auto Source : Sources){
+            std::fill(Distances.begin(), Distances.end(), std::numeric_limits< double >::infinity());
+            std::priority_queue< TQueueEntry, std::vector< TQueueEntry >, std::greater< TQueueEntry > > Queue;
+            Distances[Source] = 0.0;
+            Queue.emplace(0.0, Source);
+            while(!Queue.empty()){
+                auto Current = Queue.top();
+                Queue.pop();
+                if(Current.first > Distances[Current.second]){
+                    continue;
+                }
+                Settled++;
+                auto Location = StreetMap->NodeHandleByIndex(Current.second)->Location();
+                for(std::size_t Edge = Graph.DOffsets[Current.second]; Edge < Graph.DOffsets[Current.second + 1]; Edge++){
+                    std::size_t Next = Graph.DTargets[Edge];
+                    double Candidate = Current.first + GeographicUtils::EquirectangularDistance(Location, StreetMap->NodeHandleByIndex(Next)->Location());
+                    if(Candidate < Distances[Next]){
+                        Distances[Next] = Candidate;
+                        Queue.emplace(Candidate, Next);
+                    }
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(Settled);
+    state.counters["index_gap"] = Graph.DTargets.empty() ? 0.0 : Gap / Graph.DTargets.size();
+}
+BENCHMARK(BM_OpenStreetMapDijkstra)->ArgsProduct({{0, 1}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+// small random boxes answered through a uniform grid of node indices, every candidate's location is read to test it
+static void BM_OpenStreetMapBoxQuery(benchmark::State &state){
+    auto StreetMap = OrderedMap(state.range(0), state.range(1));
+    const std::size_t Cells = 128;
+    CStreetMap::TLocation LowerLeft(90.0, 180.0), UpperRight(-90.0, -180.0);
+    for(std::size_t Node = 0; Node < StreetMap->NodeCount(); Node++){
+        auto Location = StreetMap->NodeHandleByIndex(Node)->Location();
+        LowerLeft = {std::min(LowerLeft.first, Location.first), std::min(LowerLeft.second, Location.second)};
+        UpperRight = {std::max(UpperRight.first, Location.first), std::max(UpperRight.second, Location.second)};
+    }
+    double CellHeight = (UpperRight.first - LowerLeft.first) / Cells + 1e-12;
+    double CellWidth = (UpperRight.second - LowerLeft.second) / Cells + 1e-12;
+    auto Row = [&](double latitude){
+        return std::min(Cells - 1, std::size_t(std::max(0.0, (latitude - LowerLeft.first) / CellHeight)));
+    };
+    auto Column = [&](double longitude){
+        return std::min(Cells - 1, std::size_t(std::max(0.0, (longitude - LowerLeft.second) / CellWidth)));
+    };
+    std::vector< std::vector< std::size_t > > Grid(Cells * Cells);
+    for(std::size_t Node = 0; Node < StreetMap->NodeCount(); Node++){
+        auto Location = StreetMap->NodeHandleByIndex(Node)->Location();
+        Grid[Row(Location.first) * Cells + Column(Location.second)].push_back(Node);
+    }
+    // each box is about 5% of the map on a side
+    std::mt19937_64 Generator(42);
+    std::uniform_real_distribution< double > Fraction(0.0, 0.95);
+    std::vector< std::pair< CStreetMap::TLocation, CStreetMap::TLocation > > Boxes(1000);
+    for(auto &Box : Boxes){
+        Box.first = {LowerLeft.first + Fraction(Generator) * (UpperRight.first - LowerLeft.first), LowerLeft.second + Fraction(Generator) * (UpperRight.second - LowerLeft.second)};
+        Box.second = {Box.first.first + 0.05 * (UpperRight.first - LowerLeft.first), Box.first.second + 0.05 * (UpperRight.second - LowerLeft.second)};
+    }
+    std::size_t Found = 0, Candidates = 0;
+    for(auto _ : state){
+        for(auto &Box : Boxes){
+            for(std::size_t CellRow = Row(Box.first.first); CellRow <= Row(Box.second.first); CellRow++){
+                for(std::size_t CellColumn = Column(Box.first.second); CellColumn <= Column(Box.second.second); CellColumn++){
+                    for(auto Node : Grid[CellRow * Cells + CellColumn]){
+                        auto Location = StreetMap->NodeHandleByIndex(Node)->Location();
+                        Candidates++;
+                        Found += Location.first >= Box.first.first && Location.first <= Box.second.first && Location.second >= Box.first.second && Location.second <= Box.second.second;
+                    }
+                }
+            }
+        }
+    }
+    benchmark::DoNotOptimize(Found);
+    state.SetItemsProcessed(Candidates);
+}
+BENCHMARK(BM_OpenStreetMapBoxQuery)->ArgsProduct({{0, 1}, {0, 1}})->Unit(benchmark::kMillisecond);
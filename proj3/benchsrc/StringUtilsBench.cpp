@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+#include "StringUtils.h"
+#include <random>
+
+// pairs of street-name-like strings of roughly the requested length
+static std::vector< std::pair< std::string, std::string > > NamePairs(std::size_t length){
+    std::vector< std::pair< std::string, std::string > > Pairs;
+    std::mt19937 Generator(29);
+    const std::string Alphabet = "abcdefghijklmnopqrstuvwxyz ABCDE";
+    for(int Index = 0; Index < 256; Index++){
+        std::string Left, Right;
+        for(std::size_t Char = 0; Char < length; Char++){
+            Left += Alphabet[Generator() % Alphabet.size()];
+        }
+        Right = Left;
+        for(int Edit = 0; Edit < 3; Edit++){
+            Right[Generator() % Right.size()] = Alphabet[Generator() % Alphabet.size()];
+        }
+        Pairs.emplace_back(Left, Right);
+    }
+    return Pairs;
+}
+
+static void BM_EditDistance(benchmark::State &state){
+    auto Pairs = NamePairs(state.range(0));
+    std::size_t Next = 0;
+    for(auto _ : state){
+        auto &Pair = Pairs[Next++ & 255];
+        benchmark::DoNotOptimize(StringUtils::EditDistance(Pair.first, Pair.second, state.range(1) != 0));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_EditDistance)->ArgsProduct({{16, 64, 256}, {0, 1}});
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+static void BM_XMLReadEntity(benchmark::State &state){
+    const std::string &Data = BenchFile("data/davis.osm");
+    SXMLEntity Entity;
+    int64_t Entities = 0;
+    for(auto _ : state){
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Data));
+        while(Reader.ReadEntity(Entity, true)){
+            Entities++;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities/s"] = benchmark::Counter(Entities, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_XMLReadEntity)->Unit(benchmark::kMillisecond);
+
+static void BM_XMLWriteEntity(benchmark::State &state){
+    std::vector< SXMLEntity > Entities;
+    CXMLReader Reader(std::make_shared<CStringDataSource>(BenchFile("data/davis.osm")));
+    SXMLEntity Entity;
+    std::size_t Bytes = 0;
+    while(Reader.ReadEntity(Entity, true)){
+        Entities.push_back(Entity);
+    }
+    for(auto _ : state){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CXMLWriter Writer(Sink);
+        for(auto &Output : Entities){
+            Writer.WriteEntity(Output);
+        }
+        Writer.Flush();
+        Bytes += Sink->String().size();
+    }
+    state.SetBytesProcessed(Bytes);
+    state.counters["entities/s"] = benchmark::Counter(state.iterations() * Entities.size(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_XMLWriteEntity)->Unit(benchmark::kMillisecond);
+
+// reads every element start but discards the children of ways unseen, compare with BM_XMLReadEntity
+static void BM_XMLSkipElement(benchmark::State &state){
+    const std::string &Data = BenchFile("data/davis.osm");
+    SXMLEntity Entity;
+    int64_t Entities = 0;
+    for(auto _ : state){
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Data));
+        while(Reader.ReadEntity(Entity, true)){
+            Entities++;
+            if(Entity.DType == SXMLEntity::EType::StartElement && Entity.DNameData == "way"){
+                Reader.SkipElement();
+            }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities/s"] = benchmark::Counter(Entities, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_XMLSkipElement)->Unit(benchmark::kMillisecond);
@@ -30,6 +30,18 @@ class CBusSystem{
         virtual std::shared_ptr<SStop> StopByID(TStopID id) const noexcept = 0;
         virtual std::shared_ptr<SRoute> RouteByIndex(std::size_t index) const noexcept = 0;
         virtual std::shared_ptr<SRoute> RouteByName(const std::string &name) const noexcept = 0;
+        virtual std::size_t StopRouteCount(TStopID id) const noexcept = 0;
+        virtual std::shared_ptr<SRoute> StopRouteByIndex(TStopID id, std::size_t index) const noexcept = 0;
+        virtual std::size_t NodeStopCount(CStreetMap::TNodeID id) const noexcept = 0;
+        virtual std::shared_ptr<SStop> NodeStopByIndex(CStreetMap::TNodeID id, std::size_t index) const noexcept = 0;
+
+        // non-owning variants of the lookups above, the pointers stay valid for the lifetime of the bus system
+        virtual const SStop *StopHandleByIndex(std::size_t index) const noexcept = 0;
+        virtual const SStop *StopHandleByID(TStopID id) const noexcept = 0;
+        virtual const SRoute *RouteHandleByIndex(std::size_t index) const noexcept = 0;
+        virtual const SRoute *RouteHandleByName(const std::string &name) const noexcept = 0;
+        virtual const SRoute *StopRouteHandleByIndex(TStopID id, std::size_t index) const noexcept = 0;
+        virtual const SStop *NodeStopHandleByIndex(CStreetMap::TNodeID id, std::size_t index) const noexcept = 0;
 };
 
 #endif
@@ -3,11 +3,13 @@
 
 #include "BusSystem.h"
 #include "DSVReader.h"
+#include "NumberUtils.h"
 
 class CCSVBusSystem : public CBusSystem{
    
     public:
-        CCSVBusSystem(std::shared_ptr< CDSVReader > stopsrc, std::shared_ptr< CDSVReader > routesrc);
+        // stats, when given, receives the phase timings, counts and memory use of this load
+        CCSVBusSystem(std::shared_ptr< CDSVReader > stopsrc, std::shared_ptr< CDSVReader > routesrc, SLoadStats *stats = nullptr);
         ~CCSVBusSystem();
 
         std::size_t StopCount() const noexcept override;
@@ -16,6 +18,22 @@ class CCSVBusSystem : public CBusSystem{
         std::shared_ptr<SStop> StopByID(TStopID id) const noexcept override;
         std::shared_ptr<SRoute> RouteByIndex(std::size_t index) const noexcept override;
         std::shared_ptr<SRoute> RouteByName(const std::string &name) const noexcept override;
+        std::size_t StopRouteCount(TStopID id) const noexcept override;
+        std::shared_ptr<SRoute> StopRouteByIndex(TStopID id, std::size_t index) const noexcept override;
+        std::size_t NodeStopCount(CStreetMap::TNodeID id) const noexcept override;
+        std::shared_ptr<SStop> NodeStopByIndex(CStreetMap::TNodeID id, std::size_t index) const noexcept override;
+        const CBusSystem::SStop *StopHandleByIndex(std::size_t index) const noexcept override;
+        const CBusSystem::SStop *StopHandleByID(TStopID id) const noexcept override;
+        const CBusSystem::SRoute *RouteHandleByIndex(std::size_t index) const noexcept override;
+        const CBusSystem::SRoute *RouteHandleByName(const std::string &name) const noexcept override;
+        const CBusSystem::SRoute *StopRouteHandleByIndex(TStopID id, std::size_t index) const noexcept override;
+        const CBusSystem::SStop *NodeStopHandleByIndex(CStreetMap::TNodeID id, std::size_t index) const noexcept override;
+
+        // batch lookups, entry i of the results is for ids[i], StopCount() and nullptr mean no such stop
+        void StopIndicesByID(const TStopID *ids, std::size_t count, std::size_t *indices) const;
+        void StopHandlesByID(const TStopID *ids, std::size_t count, const CBusSystem::SStop **stops) const;
+        // ids that did not decode, their rows were skipped
+        const SParseErrors &ParseErrors() const noexcept;
     private:
         struct SImplementation;
         std::unique_ptr< SImplementation > DImplementation;
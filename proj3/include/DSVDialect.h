@@ -0,0 +1,177 @@
+#ifndef DSVDIALECT_H
+#define DSVDIALECT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "DataSink.h"
+#include "DataSource.h"
+
+// how rows end, CRLF reads a \r just before a row ending \n as part of the ending and writes \r\n,
+// a lone \n still ends a row when reading
+enum class EDSVLineEnding{LF, CRLF};
+
+// a DSV format fixed at compile time, so the reader and writer scanning loops compare against constants,
+// without quoting the quote character is ordinary and fields cannot hold the delimiter or a line ending
+template <char Delimiter, char Quote = '"', EDSVLineEnding LineEnding = EDSVLineEnding::LF, bool Quoting = true>
+struct SDSVDialect{
+    static constexpr char DDelimiter = Delimiter;
+    static constexpr char DQuote = Quote;
+    static constexpr EDSVLineEnding DLineEnding = LineEnding;
+    static constexpr bool DQuoting = Quoting;
+
+    // stops the unquoted scan of a field, a character that is ordinary in this dialect never does
+    static constexpr bool Special(char ch) noexcept{
+        return ch == Delimiter || ch == '\n' || (Quoting && ch == Quote) || (LineEnding == EDSVLineEnding::CRLF && ch == '\r');
+    }
+};
+
+// reads rows like CDSVReader, with the quote character and line ending of the dialect
+template <typename TDialect>
+class CDSVDialectReader{
+    private:
+        static constexpr std::size_t BlockSize = 1 << 14;
+        std::shared_ptr< CDataSource > DSource;
+        std::vector<char> DBuffer;
+        std::size_t DIndex = 0;
+
+        bool Fill(){
+            DIndex = 0;
+            DSource->Read(DBuffer, BlockSize);
+            return !DBuffer.empty();
+        }
+
+        bool Available(){
+            return DIndex < DBuffer.size() || Fill();
+        }
+
+    public:
+        explicit CDSVDialectReader(std::shared_ptr< CDataSource > src) : DSource(src){
+        }
+
+        bool End() const{
+            return DIndex == DBuffer.size() && DSource->End();
+        }
+
+        bool ReadRow(std::vector< std::string > &row){
+            row.clear();
+            row.emplace_back();
+            std::string *Field = &row.back();
+            bool Quoted = false;
+            while(Available()){
+                const char *Data = DBuffer.data();
+                std::size_t Size = DBuffer.size();
+                std::size_t Begin = DIndex;
+                if(Quoted){
+                    while(DIndex < Size && Data[DIndex] != TDialect::DQuote){
+                        DIndex++;
+                    }
+                }
+                else{
+                    while(DIndex < Size && !TDialect::Special(Data[DIndex])){
+                        DIndex++;
+                    }
+                }
+                Field->append(Data + Begin, DIndex - Begin);
+                if(DIndex == Size){
+                    continue;
+                }
+                char Char = DBuffer[DIndex++];
+                if(TDialect::DQuoting && Char == TDialect::DQuote){
+                    // a doubled quote is a literal one, anything else opens or closes quoting
+                    if(Available() && DBuffer[DIndex] == TDialect::DQuote){
+                        DIndex++;
+                        *Field += TDialect::DQuote;
+                    }
+                    else{
+                        Quoted = !Quoted;
+                    }
+                }
+                else if(TDialect::DLineEnding == EDSVLineEnding::CRLF && Char == '\r'){
+                    if(Available() && DBuffer[DIndex] == '\n'){
+                        DIndex++;
+                        return true;
+                    }
+                    *Field += '\r';
+                }
+                else if(Char == '\n'){
+                    return true;
+                }
+                else{
+                    row.emplace_back();
+                    Field = &row.back();
+                }
+            }
+            // nothing but an empty last field means there was no row left
+            if(row.size() > 1 || !row.back().empty()){
+                return true;
+            }
+            row.clear();
+            return false;
+        }
+};
+
+// writes rows like CDSVWriter, a whole row at a time, fields holding the delimiter, the quote or a line
+// ending are quoted, without quoting such a row is refused and nothing of it is written
+template <typename TDialect>
+class CDSVDialectWriter{
+    private:
+        std::shared_ptr< CDataSink > DSink;
+        bool DQuoteAll;
+        std::vector<char> DBuffer;
+
+        static bool NeedsQuotes(const std::string &field) noexcept{
+            for(char Char : field){
+                if(Char == TDialect::DDelimiter || Char == '\n' || Char == '\r' || Char == TDialect::DQuote){
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    public:
+        explicit CDSVDialectWriter(std::shared_ptr< CDataSink > sink, bool quoteall = false) : DSink(sink), DQuoteAll(quoteall && TDialect::DQuoting){
+        }
+
+        bool WriteRow(const std::vector< std::string > &row){
+            DBuffer.clear();
+            for(std::size_t Index = 0; Index < row.size(); Index++){
+                const std::string &Field = row[Index];
+                if(!TDialect::DQuoting){
+                    for(char Char : Field){
+                        if(Char == TDialect::DDelimiter || Char == '\n' || Char == '\r'){
+                            return false;
+                        }
+                    }
+                    DBuffer.insert(DBuffer.end(), Field.begin(), Field.end());
+                }
+                else if(DQuoteAll || NeedsQuotes(Field)){
+                    DBuffer.push_back(TDialect::DQuote);
+                    for(char Char : Field){
+                        if(Char == TDialect::DQuote){
+                            DBuffer.push_back(TDialect::DQuote);
+                        }
+                        DBuffer.push_back(Char);
+                    }
+                    DBuffer.push_back(TDialect::DQuote);
+                }
+                else{
+                    DBuffer.insert(DBuffer.end(), Field.begin(), Field.end());
+                }
+                if(Index + 1 < row.size()){
+                    DBuffer.push_back(TDialect::DDelimiter);
+                }
+            }
+            if(TDialect::DLineEnding == EDSVLineEnding::CRLF){
+                DBuffer.push_back('\r');
+            }
+            DBuffer.push_back('\n');
+            return DSink->Write(DBuffer);
+        }
+};
+
+using SCSVDialect = SDSVDialect<','>;
+using STSVDialect = SDSVDialect<'\t', '"', EDSVLineEnding::LF, false>;
+using SExcelCSVDialect = SDSVDialect<',', '"', EDSVLineEnding::CRLF>;
+
+#endif
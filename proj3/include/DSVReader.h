@@ -3,7 +3,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "DataSource.h"
+#include "LoadStats.h"
 
 class CDSVReader{
     private:
@@ -16,6 +18,15 @@ class CDSVReader{
 
         bool End() const;
         bool ReadRow(std::vector<std::string> &row);
+        // while set, bytes read and time spent splitting rows are added to stats, null stops it,
+        // blocks are pulled from the source while splitting so reading is counted as part of tokenizing
+        void SetStats(SLoadStats *stats) noexcept;
+        // header is the row naming the columns of the rows after it, later rows hold only the named columns
+        // in the order given and the others are skipped without being copied, a column missing from the header
+        // or named twice returns false and leaves the reader as it was
+        bool SelectColumns(const std::vector< std::string > &header, const std::vector< std::string > &columns);
+        // reads the next row, whole, as the header and selects columns from it
+        bool ReadHeader(const std::vector< std::string > &columns);
 };
 
 #endif
@@ -0,0 +1,59 @@
+#ifndef DSVROWINDEX_H
+#define DSVROWINDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DataSink.h"
+#include "DSVReader.h"
+#include "SeekableDataSource.h"
+
+// byte offsets of every interval-th row of a DSV source, found with the same quoting rules as CDSVReader
+// so a newline inside a quoted field does not start a row, every checkpoint is a row start and so unquoted
+class CDSVRowIndex{
+    private:
+        std::size_t DInterval;
+        std::size_t DRowCount = 0;
+        std::size_t DSourceSize = 0;
+        uint64_t DSourceHash = 0; // of the first and last block of the source
+        std::vector< std::size_t > DOffsets; // DOffsets[i] is where row i * DInterval starts
+
+    public:
+        explicit CDSVRowIndex(std::size_t interval = 1024);
+
+        // scans the whole source from its start
+        bool Build(CSeekableDataSource &src);
+        // the sidecar is a small DSV file, Load refuses one written for a source of another size or whose first
+        // and last block hash differently, which reads those blocks of indexed and leaves it at an unknown position
+        bool Save(std::shared_ptr< CDataSink > sink) const;
+        bool Load(std::shared_ptr< CDataSource > src, CSeekableDataSource &indexed);
+
+        std::size_t Interval() const noexcept;
+        std::size_t RowCount() const noexcept;
+        // the checkpoint at or before row, false if row is past the end
+        bool Checkpoint(std::size_t row, std::size_t &checkpointrow, std::size_t &offset) const noexcept;
+};
+
+// reads rows of an indexed source from any row on, seeking to the nearest checkpoint and skipping fewer than
+// an interval of rows, sources are not shared so readers on separate sources can page in parallel
+class CIndexedDSVReader{
+    private:
+        std::shared_ptr< CSeekableDataSource > DSource;
+        std::shared_ptr< const CDSVRowIndex > DIndex;
+        char DDelimiter;
+        std::unique_ptr< CDSVReader > DReader;
+        std::size_t DRow = 0;
+
+    public:
+        CIndexedDSVReader(std::shared_ptr< CSeekableDataSource > src, char delimiter, std::shared_ptr< const CDSVRowIndex > index);
+        ~CIndexedDSVReader();
+
+        bool SeekRow(std::size_t row);
+        // the row the next ReadRow returns
+        std::size_t Row() const noexcept;
+        bool End() const;
+        bool ReadRow(std::vector< std::string > &row);
+};
+
+#endif
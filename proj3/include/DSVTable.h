@@ -0,0 +1,55 @@
+#ifndef DSVTABLE_H
+#define DSVTABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DSVReader.h"
+#include "NumberUtils.h"
+
+// a DSV file loaded in one pass into typed columns, each held in its own contiguous array
+class CDSVTable{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // strings are dictionary encoded, each distinct value is stored once and cells hold its code
+        enum class EType{Int64, Double, String};
+
+        struct SColumnSchema{
+            std::string DName;
+            EType DType;
+        };
+
+        // the types are inferred from the first samplerows rows, the narrowest type every non-empty cell of a
+        // column decodes as, without a header the columns are named by position and counted from the first row
+        CDSVTable(std::shared_ptr< CDSVReader > src, bool header = true, std::size_t samplerows = 1024);
+        // with a schema the header, when there is one, only locates the named columns
+        CDSVTable(std::shared_ptr< CDSVReader > src, const std::vector< SColumnSchema > &schema, bool header = true);
+        ~CDSVTable();
+
+        std::size_t RowCount() const noexcept;
+        std::size_t ColumnCount() const noexcept;
+        // ColumnCount() when there is no such column
+        std::size_t ColumnIndex(const std::string &name) const noexcept;
+        const std::string &ColumnName(std::size_t column) const noexcept;
+        EType ColumnType(std::size_t column) const noexcept;
+
+        // empty cells, missing cells of short rows and cells that do not decode as the column type are null,
+        // ValidColumn holds 1 for each non-null cell and the typed arrays hold 0 for null ones
+        const uint8_t *ValidColumn(std::size_t column) const noexcept;
+        std::size_t NullCount(std::size_t column) const noexcept;
+        // RowCount() values, nullptr when the column is of another type
+        const int64_t *Int64Column(std::size_t column) const noexcept;
+        const double *DoubleColumn(std::size_t column) const noexcept;
+        const uint32_t *StringCodes(std::size_t column) const noexcept;
+        std::size_t DictionarySize(std::size_t column) const noexcept;
+        const std::string &DictionaryValue(std::size_t column, uint32_t code) const noexcept;
+
+        // cells that were not empty but did not decode as their column type
+        const SParseErrors &ParseErrors() const noexcept;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef FILEDATASINK_H
+#define FILEDATASINK_H
+
+#include "DataSink.h"
+#include <cstdio>
+#include <string>
+
+class CFileDataSink : public CDataSink{
+    private:
+        std::FILE *DFile;
+    public:
+        CFileDataSink(const std::string &filename);
+        ~CFileDataSink();
+
+        bool IsOpen() const noexcept;
+        bool Flush() noexcept;
+
+        bool Put(const char &ch) noexcept override;
+        bool Write(const std::vector<char> &buf) noexcept override;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef FILEDATASOURCE_H
+#define FILEDATASOURCE_H
+
+#include "SeekableDataSource.h"
+#include <cstdio>
+#include <string>
+
+class CFileDataSource : public CSeekableDataSource{
+    private:
+        std::FILE *DFile;
+        std::size_t DSize;
+    public:
+        CFileDataSource(const std::string &filename);
+        ~CFileDataSource();
+
+        bool IsOpen() const noexcept;
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        std::size_t Size() const noexcept override;
+        std::size_t Tell() const noexcept override;
+        bool Seek(std::size_t position) noexcept override;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef GEOGRAPHICUTILS_H
+#define GEOGRAPHICUTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "StreetMap.h"
+
+// a location in 1e-7 degrees, the precision osm stores, in half the space of a TLocation
+struct SFixedLocation{
+    int32_t DLatitude = 0;
+    int32_t DLongitude = 0;
+
+    bool operator==(const SFixedLocation &other) const noexcept{
+        return DLatitude == other.DLatitude && DLongitude == other.DLongitude;
+    }
+};
+
+namespace GeographicUtils{
+
+using TLocation = CStreetMap::TLocation;
+
+constexpr double FixedUnitsPerDegree = 1e7;
+constexpr double EarthRadiusMeters = 6371008.8;
+
+// rounds to the nearest unit, degrees outside of [-214, 214] do not fit
+SFixedLocation ToFixed(const TLocation &location) noexcept;
+TLocation FromFixed(const SFixedLocation &location) noexcept;
+
+// position along a hilbert curve over the whole fixed point plane, nearby keys are nearby on the ground
+uint64_t HilbertIndex(const SFixedLocation &location) noexcept;
+
+// great circle distance in meters
+double HaversineDistance(const TLocation &src, const TLocation &dest) noexcept;
+// flat earth approximation at the mean latitude, within 0.1% of haversine up to tens of kilometers
+double EquirectangularDistance(const TLocation &src, const TLocation &dest) noexcept;
+// initial bearing in degrees clockwise from north, in [0, 360)
+double Bearing(const TLocation &src, const TLocation &dest) noexcept;
+
+// batch forms, results[i] is from origin to points[i]
+void HaversineDistances(const TLocation &origin, const TLocation *points, std::size_t count, double *results) noexcept;
+void HaversineDistances(const TLocation &origin, const SFixedLocation *points, std::size_t count, double *results) noexcept;
+void EquirectangularDistances(const TLocation &origin, const TLocation *points, std::size_t count, double *results) noexcept;
+void EquirectangularDistances(const TLocation &origin, const SFixedLocation *points, std::size_t count, double *results) noexcept;
+void Bearings(const TLocation &origin, const TLocation *points, std::size_t count, double *results) noexcept;
+void Bearings(const TLocation &origin, const SFixedLocation *points, std::size_t count, double *results) noexcept;
+
+// results[i] is the haversine distance from locations[sources[i]] to locations[targets[i]], the cosine of
+// each latitude is computed once per location rather than once per pair, suited to graph edge weights
+void HaversineDistances(const SFixedLocation *locations, std::size_t locationcount, const uint32_t *sources, const uint32_t *targets, std::size_t count, double *results);
+
+}
+
+#endif
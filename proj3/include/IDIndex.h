@@ -0,0 +1,37 @@
+#ifndef IDINDEX_H
+#define IDINDEX_H
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// maps 64 bit ids to their positions 0..n-1, lookups probe an open addressing table with the probes of a
+// batch prefetched ahead, large batches that are already sorted are merged against a sorted id column instead
+class CIDIndex{
+    private:
+        using TEntry = std::pair< uint64_t, std::size_t >; // id and position, position NotFound marks an empty slot
+        std::vector< TEntry > DSorted;
+        std::vector< TEntry > DSlots;
+        uint64_t DMask = 0;
+        int DShift = 64;
+
+        std::size_t Slot(uint64_t id) const noexcept;
+
+    public:
+        static constexpr std::size_t NotFound = std::numeric_limits<std::size_t>::max();
+        // sorted batches at least this large, and half the index, are merged rather than probed
+        static constexpr std::size_t MergeThreshold = 4096;
+
+        // ids[i] is at position i, a repeated id resolves to its first position
+        void Build(const uint64_t *ids, std::size_t count);
+        std::size_t Size() const noexcept;
+
+        std::size_t Find(uint64_t id) const noexcept;
+        // positions[i] receives the position of ids[i] or NotFound, choosing between the two methods below
+        void Find(const uint64_t *ids, std::size_t count, std::size_t *positions) const;
+        void FindProbed(const uint64_t *ids, std::size_t count, std::size_t *positions) const noexcept;
+        void FindMerged(const uint64_t *ids, std::size_t count, std::size_t *positions) const;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef LAZYOPENSTREETMAP_H
+#define LAZYOPENSTREETMAP_H
+
+#include "SeekableDataSource.h"
+#include "StreetMap.h"
+
+// street map over OSM XML that only indexes ids, coordinates and byte offsets up front, nodes and ways are
+// decoded from the source on first access and the most recently used are cached, the source must stay
+// unchanged while the map is in use
+class CLazyOpenStreetMap : public CStreetMap{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // while open, handles this thread takes from the map are pinned by the scope rather than by the map and
+        // become invalid when it is destroyed, scopes nest and must be destroyed on the thread that opened them
+        class CHandleScope{
+            private:
+                struct SImplementation;
+                std::unique_ptr<SImplementation> DImplementation;
+
+            public:
+                explicit CHandleScope(const CLazyOpenStreetMap &streetmap);
+                ~CHandleScope();
+                CHandleScope(const CHandleScope &) = delete;
+                CHandleScope &operator=(const CHandleScope &) = delete;
+
+                std::size_t PinnedCount() const noexcept;
+        };
+
+        // cachesize bounds the decoded nodes plus ways kept alive by the map itself
+        CLazyOpenStreetMap(std::shared_ptr<CSeekableDataSource> src, std::size_t cachesize = 4096);
+        ~CLazyOpenStreetMap();
+
+        std::size_t NodeCount() const noexcept override;
+        std::size_t WayCount() const noexcept override;
+        std::shared_ptr<CStreetMap::SNode> NodeByIndex(std::size_t index) const noexcept override;
+        std::shared_ptr<CStreetMap::SNode> NodeByID(TNodeID id) const noexcept override;
+        std::shared_ptr<CStreetMap::SWay> WayByIndex(std::size_t index) const noexcept override;
+        std::shared_ptr<CStreetMap::SWay> WayByID(TWayID id) const noexcept override;
+        // a handle pins its element outside of the cache, for the lifetime of the map unless a CHandleScope is
+        // open on the calling thread, so walking the whole map through handles outside of a scope keeps every
+        // element decoded
+        const CStreetMap::SNode *NodeHandleByIndex(std::size_t index) const noexcept override;
+        const CStreetMap::SNode *NodeHandleByID(TNodeID id) const noexcept override;
+        const CStreetMap::SWay *WayHandleByIndex(std::size_t index) const noexcept override;
+        const CStreetMap::SWay *WayHandleByID(TWayID id) const noexcept override;
+
+        // known from the index without decoding the node
+        TLocation NodeLocation(std::size_t index) const noexcept;
+        std::size_t CachedCount() const noexcept;
+        // elements pinned by handles taken outside of any scope
+        std::size_t PinnedCount() const noexcept;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef LOADSTATS_H
+#define LOADSTATS_H
+
+#include <chrono>
+#include <cstddef>
+
+// where the time and memory of a load went, filled in when passed to a loader and left untouched otherwise
+struct SLoadStats{
+    // phases in seconds, reading from the data source, tokenizing into entities or rows,
+    // building the loaded objects and building lookup indices
+    double DIOSeconds = 0.0;
+    double DTokenizeSeconds = 0.0;
+    double DBuildSeconds = 0.0;
+    double DIndexSeconds = 0.0;
+    std::size_t DBytesRead = 0;
+
+    std::size_t DNodeCount = 0;
+    std::size_t DWayCount = 0;
+    std::size_t DTagCount = 0;
+    std::size_t DStopCount = 0;
+    std::size_t DRouteCount = 0;
+
+    // operator new calls made by the loading thread while loading, only counted in binaries that link
+    // AllocCounter.o, which replaces the global allocator, and 0 everywhere else
+    std::size_t DAllocationCount = 0;
+    std::size_t DAllocatedBytes = 0;
+    // peak resident set of the whole process when the load finished, 0 where the platform does not report it
+    std::size_t DPeakResidentBytes = 0;
+
+    double TotalSeconds() const noexcept{
+        return DIOSeconds + DTokenizeSeconds + DBuildSeconds + DIndexSeconds;
+    }
+};
+
+// adds the wall time between construction and Stop (or destruction) to a phase, all no-ops for a null phase
+class CLoadPhaseTimer{
+    private:
+        double *DPhase;
+        std::chrono::steady_clock::time_point DStart;
+
+    public:
+        explicit CLoadPhaseTimer(double *phase) noexcept : DPhase(phase){
+            if(DPhase){
+                DStart = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~CLoadPhaseTimer(){
+            Stop();
+        }
+
+        void Stop() noexcept{
+            if(DPhase){
+                *DPhase += std::chrono::duration<double>(std::chrono::steady_clock::now() - DStart).count();
+                DPhase = nullptr;
+            }
+        }
+};
+
+// counts allocations of the current thread into stats for its lifetime and records peak memory at the end,
+// a null stats costs a branch here and, when AllocCounter.o is linked, one thread local test per allocation
+class CLoadStatsRecorder{
+    private:
+        SLoadStats *DStats;
+        std::size_t DAllocationCount;
+        std::size_t DAllocatedBytes;
+        bool DWasCounting;
+
+    public:
+        explicit CLoadStatsRecorder(SLoadStats *stats) noexcept;
+        ~CLoadStatsRecorder();
+
+        // called by the replacement allocator in AllocCounter.o for every allocation
+        static void CountAllocation(std::size_t size) noexcept;
+};
+
+#endif
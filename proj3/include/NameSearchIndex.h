@@ -0,0 +1,41 @@
+#ifndef NAMESEARCHINDEX_H
+#define NAMESEARCHINDEX_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "StreetMap.h"
+#include "BusSystem.h"
+
+class CNameSearchIndex{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        enum class EType{Node, Way, Route};
+
+        struct SEntry{
+            EType DType;
+            uint64_t DID; // node id, way id or route index
+        };
+
+        struct SMatch{
+            std::string DName;
+            int DDistance;
+            std::vector< SEntry > DEntries;
+        };
+
+        CNameSearchIndex();
+        // indexes the name tag of every node and way and the name of every route, either source may be null
+        CNameSearchIndex(std::shared_ptr<CStreetMap> streetmap, std::shared_ptr<CBusSystem> bussystem);
+        ~CNameSearchIndex();
+
+        // names are compared case insensitively, the first spelling added is the one reported
+        void AddName(const std::string &name, EType type, uint64_t id);
+        std::size_t NameCount() const noexcept;
+        // up to count closest names within maxdistance edits, ordered by distance then name
+        std::vector< SMatch > Search(const std::string &query, std::size_t count, int maxdistance = 3) const;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef NUMBERUTILS_H
+#define NUMBERUTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// values a loader could not decode, by what was wrong with them
+struct SParseErrors{
+    std::size_t DEmpty = 0;
+    std::size_t DInvalid = 0; // not a number, or followed by something other than whitespace
+    std::size_t DOutOfRange = 0;
+
+    std::size_t Total() const noexcept{
+        return DEmpty + DInvalid + DOutOfRange;
+    }
+};
+
+namespace NumberUtils{
+
+// locale independent and exception free, surrounding whitespace and a leading + are allowed,
+// on failure value is left untouched and the reason is counted in errors when given
+bool ToUInt64(std::string_view str, uint64_t &value, SParseErrors *errors = nullptr) noexcept;
+bool ToInt64(std::string_view str, int64_t &value, SParseErrors *errors = nullptr) noexcept;
+bool ToDouble(std::string_view str, double &value, SParseErrors *errors = nullptr) noexcept;
+
+}
+
+#endif
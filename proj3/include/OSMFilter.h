@@ -0,0 +1,40 @@
+#ifndef OSMFILTER_H
+#define OSMFILTER_H
+
+#include <memory>
+#include <string>
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "StreetMap.h"
+
+// copies OSM XML from a reader to a writer keeping only the selected nodes and ways, one element
+// is held at a time so memory grows with the ids selected rather than with the input
+class COSMFilter{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        enum class EElement{Node, Way};
+
+        COSMFilter();
+        ~COSMFilter();
+
+        // nodes must lie inside the box and ways must reference at least one node that does
+        void SetBoundingBox(CStreetMap::TLocation lowerleft, CStreetMap::TLocation upperright);
+        // elements of the given kind must carry at least one of the added tags, a value of "*" matches any value
+        void AddTagFilter(EElement element, const std::string &key, const std::string &value = "*");
+        // with reference closure, Filter only writes nodes that a kept way references
+        void SetReferencedNodesOnly(bool only) noexcept;
+
+        // one pass, nodes and ways are kept by their own filters so kept ways may reference dropped nodes
+        bool Filter(std::shared_ptr<CXMLReader> src, std::shared_ptr<CXMLWriter> dest);
+        // two passes over the same input, the first finds the kept ways so the second also writes every node they reference
+        bool Filter(std::shared_ptr<CXMLReader> scan, std::shared_ptr<CXMLReader> src, std::shared_ptr<CXMLWriter> dest);
+
+        // totals of the last Filter call
+        std::size_t KeptNodeCount() const noexcept;
+        std::size_t KeptWayCount() const noexcept;
+};
+
+#endif
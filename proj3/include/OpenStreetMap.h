@@ -3,6 +3,10 @@
 
 #include "XMLReader.h"
 #include "StreetMap.h"
+#include "NumberUtils.h"
+#include <functional>
+#include <string>
+#include <vector>
 
 class COpenStreetMap : public CStreetMap{
     private:
@@ -10,7 +14,28 @@ class COpenStreetMap : public CStreetMap{
         std::unique_ptr<SImplementation> DImplementation;
 
     public:
-        COpenStreetMap(std::shared_ptr<CXMLReader> src);
+        // what to keep while loading, everything not kept is skipped without being built
+        struct SLoadOptions{
+            using TTag = std::pair< std::string, std::string >;
+
+            // attribute and tag keys to keep on nodes and ways, empty keeps every key
+            std::vector< std::string > DTagKeys;
+            // ways are kept when this accepts their tags, unset keeps every way
+            std::function< bool(const std::vector< TTag > &tags) > DWayFilter;
+            // nodes must lie inside the box and ways must reference at least one node that does
+            bool DUseBounds = false;
+            TLocation DLowerLeft;
+            TLocation DUpperRight;
+            // keep only nodes referenced by kept ways, wherever they lie
+            bool DReferencedNodesOnly = false;
+            // number nodes along a hilbert curve of their locations, and ways by the middle of their nodes,
+            // so elements close on the ground are close in index order, nodes are also built in that order
+            bool DSpatialOrder = false;
+        };
+
+        // stats, when given, receives the phase timings, counts and memory use of this load
+        COpenStreetMap(std::shared_ptr<CXMLReader> src, SLoadStats *stats = nullptr);
+        COpenStreetMap(std::shared_ptr<CXMLReader> src, const SLoadOptions &options, SLoadStats *stats = nullptr);
         ~COpenStreetMap();
 
         std::size_t NodeCount() const noexcept override;
@@ -19,9 +44,20 @@ class COpenStreetMap : public CStreetMap{
         std::shared_ptr<CStreetMap::SNode> NodeByID(TNodeID id) const noexcept override;
         std::shared_ptr<CStreetMap::SWay> WayByIndex(std::size_t index) const noexcept override;
         std::shared_ptr<CStreetMap::SWay> WayByID(TWayID id) const noexcept override;
-    private:
-        struct SImplementation;
-        std::unique_ptr<SImplementation> DImplementation;
+        const CStreetMap::SNode *NodeHandleByIndex(std::size_t index) const noexcept override;
+        const CStreetMap::SNode *NodeHandleByID(TNodeID id) const noexcept override;
+        const CStreetMap::SWay *WayHandleByIndex(std::size_t index) const noexcept override;
+        const CStreetMap::SWay *WayHandleByID(TWayID id) const noexcept override;
+
+        // batch lookups, entry i of the results is for ids[i], NodeCount() or WayCount() and nullptr mean no such element
+        void NodeIndicesByID(const TNodeID *ids, std::size_t count, std::size_t *indices) const;
+        void NodeHandlesByID(const TNodeID *ids, std::size_t count, const CStreetMap::SNode **nodes) const;
+        void WayIndicesByID(const TWayID *ids, std::size_t count, std::size_t *indices) const;
+        void WayHandlesByID(const TWayID *ids, std::size_t count, const CStreetMap::SWay **ways) const;
+        // node indices of every way at once, way i refers to indices[offsets[i] .. offsets[i + 1])
+        void ResolveWayNodes(std::vector< std::size_t > &offsets, std::vector< std::size_t > &indices) const;
+        // ids, locations and refs that did not decode, their elements or refs were skipped
+        const SParseErrors &ParseErrors() const noexcept;
 };
 
 #endif
@@ -0,0 +1,15 @@
+#ifndef SEEKABLEDATASOURCE_H
+#define SEEKABLEDATASOURCE_H
+
+#include "DataSource.h"
+
+// a data source that can jump to a byte offset, for readers that index a source and come back later
+class CSeekableDataSource : public CDataSource{
+    public:
+        virtual ~CSeekableDataSource(){};
+        virtual std::size_t Size() const noexcept = 0;
+        virtual std::size_t Tell() const noexcept = 0;
+        virtual bool Seek(std::size_t position) noexcept = 0;
+};
+
+#endif
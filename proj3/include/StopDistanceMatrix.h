@@ -0,0 +1,34 @@
+#ifndef STOPDISTANCEMATRIX_H
+#define STOPDISTANCEMATRIX_H
+
+#include <limits>
+#include <memory>
+#include "StreetMap.h"
+#include "BusSystem.h"
+#include "DSVWriter.h"
+
+class CStopDistanceMatrix{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        static constexpr double NoPathDistance = std::numeric_limits<double>::infinity();
+
+        CStopDistanceMatrix(std::shared_ptr<CStreetMap> streetmap, std::shared_ptr<CBusSystem> bussystem);
+        ~CStopDistanceMatrix();
+
+        std::size_t StopCount() const noexcept;
+        CBusSystem::TStopID StopID(std::size_t index) const noexcept;
+
+        // runs one search per stop, threadcount of 0 uses the hardware concurrency, false if a worker thread
+        // could not be started, which leaves every distance NoPathDistance
+        bool Compute(std::size_t threadcount = 0);
+        // street distance in meters, NoPathDistance if unreachable or not computed
+        double Distance(std::size_t srcindex, std::size_t destindex) const noexcept;
+        double DistanceByID(CBusSystem::TStopID src, CBusSystem::TStopID dest) const noexcept;
+        // header row of stop ids, then one row per source stop, unreachable cells are empty
+        bool Write(std::shared_ptr<CDSVWriter> writer) const;
+};
+
+#endif
@@ -45,6 +45,14 @@ class CStreetMap{
         virtual std::shared_ptr<SNode> NodeByID(TNodeID id) const noexcept = 0;
         virtual std::shared_ptr<SWay> WayByIndex(std::size_t index) const noexcept = 0;
         virtual std::shared_ptr<SWay> WayByID(TWayID id) const noexcept = 0;
+
+        // non-owning variants of the lookups above, the pointers stay valid for the lifetime of the map
+        // and avoid the reference count traffic of copying a shared_ptr, nullptr where those return nullptr,
+        // a map that decodes on demand keeps every element reached this way, see CLazyOpenStreetMap::CHandleScope
+        virtual const SNode *NodeHandleByIndex(std::size_t index) const noexcept = 0;
+        virtual const SNode *NodeHandleByID(TNodeID id) const noexcept = 0;
+        virtual const SWay *WayHandleByIndex(std::size_t index) const noexcept = 0;
+        virtual const SWay *WayHandleByID(TWayID id) const noexcept = 0;
 };
 
 #endif
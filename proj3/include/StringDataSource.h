@@ -1,10 +1,10 @@
 #ifndef STRINGDATASOURCE_H
 #define STRINGDATASOURCE_H
 
-#include "DataSource.h"
+#include "SeekableDataSource.h"
 #include <string>
 
-class CStringDataSource : public CDataSource{
+class CStringDataSource : public CSeekableDataSource{
     private:
         std::string DString;
         size_t DIndex;
@@ -15,6 +15,10 @@ class CStringDataSource : public CDataSource{
         bool Get(char &ch) noexcept override;
         bool Peek(char &ch) noexcept override;
         bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        std::size_t Size() const noexcept override;
+        std::size_t Tell() const noexcept override;
+        bool Seek(std::size_t position) noexcept override;
 };
 
 #endif
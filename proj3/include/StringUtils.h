@@ -1,15 +1,24 @@
 #ifndef STRINGUTILS_H
 #define STRINGUTILS_H
 
+#include <cstdint>
+#include <iterator>
+#include <locale>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace StringUtils{
-    
+
 std::string Slice(const std::string &str, ssize_t start, ssize_t end=0) noexcept;
 std::string Capitalize(const std::string &str) noexcept;
 std::string Upper(const std::string &str) noexcept;
 std::string Lower(const std::string &str) noexcept;
+// case mapping above is ascii only, these go through the ctype facet of locale for other letters
+std::string Capitalize(const std::string &str, const std::locale &locale) noexcept;
+std::string Upper(const std::string &str, const std::locale &locale) noexcept;
+std::string Lower(const std::string &str, const std::locale &locale) noexcept;
+// strip functions remove ' ', '\t', '\n', '\v', '\f' and '\r'
 std::string LStrip(const std::string &str) noexcept;
 std::string RStrip(const std::string &str) noexcept;
 std::string Strip(const std::string &str) noexcept;
@@ -20,7 +29,81 @@ std::string Replace(const std::string &str, const std::string &old, const std::s
 std::vector< std::string > Split(const std::string &str, const std::string &splt = "") noexcept;
 std::string Join(const std::string &str, const std::vector< std::string > &vect) noexcept;
 std::string ExpandTabs(const std::string &str, int tabsize = 4) noexcept;
-int EditDistance(const std::string &left, const std::string &right, bool ignorecase=false) noexcept;
+// a non-negative maxdistance stops early and returns maxdistance + 1 once the distance is known to exceed it
+int EditDistance(const std::string &left, const std::string &right, bool ignorecase=false, int maxdistance=-1) noexcept;
+
+// allocation free variants, View functions return a slice of str and To functions append to out,
+// so reusing out across calls allocates nothing once its capacity is large enough
+std::string_view SliceView(std::string_view str, ssize_t start, ssize_t end=0) noexcept;
+std::string_view LStripView(std::string_view str) noexcept;
+std::string_view RStripView(std::string_view str) noexcept;
+std::string_view StripView(std::string_view str) noexcept;
+void CapitalizeTo(std::string &out, std::string_view str) noexcept;
+void UpperTo(std::string &out, std::string_view str) noexcept;
+void LowerTo(std::string &out, std::string_view str) noexcept;
+void CenterTo(std::string &out, std::string_view str, int width, char fill = ' ') noexcept;
+void LJustTo(std::string &out, std::string_view str, int width, char fill = ' ') noexcept;
+void RJustTo(std::string &out, std::string_view str, int width, char fill = ' ') noexcept;
+void ReplaceTo(std::string &out, std::string_view str, std::string_view old, std::string_view rep) noexcept;
+void JoinTo(std::string &out, std::string_view str, const std::vector< std::string > &vect) noexcept;
+void ExpandTabsTo(std::string &out, std::string_view str, int tabsize = 4) noexcept;
+
+// substring searcher compiled once and reused, the pattern is copied so the source may go away
+class CPattern{
+    private:
+        std::string DPattern;
+        uint32_t DShift[256]; // horspool shift for each last character of the window
+
+    public:
+        explicit CPattern(std::string_view pattern);
+
+        const std::string &Pattern() const noexcept;
+        // index of the first match at or after pos, std::string_view::npos if none
+        std::size_t Find(std::string_view str, std::size_t pos = 0) const noexcept;
+        std::size_t Count(std::string_view str) const noexcept;
+        std::string Replace(const std::string &str, const std::string &rep) const noexcept;
+        void ReplaceTo(std::string &out, std::string_view str, std::string_view rep) const noexcept;
+        std::vector< std::string > Split(const std::string &str) const noexcept;
+};
+
+// lazy Split, iterating yields the same pieces as Split as views into str
+class CSplitView{
+    private:
+        std::string_view DString;
+        std::string_view DSeparator;
+        const CPattern *DPattern;
+
+    public:
+        class CIterator{
+            private:
+                const CSplitView *DView;
+                std::size_t DStart;
+                std::size_t DEnd;
+                void Advance(std::size_t from) noexcept;
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::string_view;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const std::string_view *;
+                using reference = std::string_view;
+
+                CIterator(const CSplitView *view, std::size_t start) noexcept;
+                std::string_view operator*() const noexcept;
+                CIterator &operator++() noexcept;
+                CIterator operator++(int) noexcept;
+                bool operator==(const CIterator &other) const noexcept;
+                bool operator!=(const CIterator &other) const noexcept;
+        };
+
+        CSplitView(std::string_view str, std::string_view splt = "") noexcept;
+        // pattern must outlive the view, an empty pattern splits on whitespace
+        CSplitView(std::string_view str, const CPattern &pattern) noexcept;
+        CIterator begin() const noexcept;
+        CIterator end() const noexcept;
+};
+
+CSplitView SplitView(std::string_view str, std::string_view splt = "") noexcept;
+CSplitView SplitView(std::string_view str, const CPattern &pattern) noexcept;
 
 }
 
@@ -0,0 +1,30 @@
+#ifndef SYNTHETICMAPGENERATOR_H
+#define SYNTHETICMAPGENERATOR_H
+
+#include <memory>
+#include "DataSink.h"
+#include "StreetMap.h"
+
+// writes a deterministic grid city of any size as OSM XML plus stops and routes CSV, without holding it in memory
+class CSyntheticMapGenerator{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // stopcount and routecount of 0 pick counts proportional to nodecount
+        CSyntheticMapGenerator(std::size_t nodecount, uint64_t seed = 1, std::size_t stopcount = 0, std::size_t routecount = 0);
+        ~CSyntheticMapGenerator();
+
+        std::size_t NodeCount() const noexcept;
+        std::size_t WayCount() const noexcept;
+        std::size_t StopCount() const noexcept;
+        std::size_t RouteCount() const noexcept;
+        CStreetMap::TNodeID NodeID(std::size_t index) const noexcept;
+
+        bool WriteOSM(std::shared_ptr<CDataSink> sink) const;
+        bool WriteStops(std::shared_ptr<CDataSink> sink) const;
+        bool WriteRoutes(std::shared_ptr<CDataSink> sink) const;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef TRANSITGRAPH_H
+#define TRANSITGRAPH_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "BusSystem.h"
+#include "StopDistanceMatrix.h"
+
+class CTransitGraph{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        struct SJourneyLeg{
+            std::string DRouteName;
+            CBusSystem::TStopID DBoardStopID;
+            CBusSystem::TStopID DAlightStopID;
+            std::size_t DRideStopCount;
+        };
+
+        struct SJourney{
+            double DArrival;
+            std::vector< SJourneyLeg > DLegs;
+
+            std::size_t Transfers() const noexcept{
+                return DLegs.empty() ? 0 : DLegs.size() - 1;
+            }
+        };
+
+        // every hop between consecutive route stops costs 1 unless a computed distance matrix is given,
+        // then hops cost their street distance in meters
+        CTransitGraph(std::shared_ptr<CBusSystem> bussystem, std::shared_ptr<CStopDistanceMatrix> distances = nullptr);
+        ~CTransitGraph();
+
+        std::size_t StopCount() const noexcept;
+        std::size_t RouteCount() const noexcept;
+        std::size_t TransferStopCount() const noexcept;
+        bool IsTransferStop(CBusSystem::TStopID id) const noexcept;
+
+        // pareto set of journeys ordered by increasing transfers, each arriving strictly earlier than the last
+        bool FindJourneys(CBusSystem::TStopID src, CBusSystem::TStopID dest, std::vector< SJourney > &journeys, std::size_t maxtransfers = 4) const;
+        bool FindMinimumTransfers(CBusSystem::TStopID src, CBusSystem::TStopID dest, SJourney &journey, std::size_t maxtransfers = 4) const;
+        bool FindEarliestArrival(CBusSystem::TStopID src, CBusSystem::TStopID dest, SJourney &journey, std::size_t maxtransfers = 4) const;
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <memory>
 #include "XMLEntity.h"
 #include "DataSource.h"
+#include "LoadStats.h"
 
 class CXMLReader{
     private:
@@ -16,6 +17,11 @@ class CXMLReader{
         
         bool End() const;
         bool ReadEntity(SXMLEntity &entity, bool skipcdata = false);
+        // discards everything up to and including the end of the innermost element whose start has been read,
+        // without building entities for it, false if no element is open or the data ends first
+        bool SkipElement();
+        // while set, bytes read and time spent reading and tokenizing are added to stats, null stops it
+        void SetStats(SLoadStats *stats) noexcept;
 };
 
 #endif
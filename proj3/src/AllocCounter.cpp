@@ -0,0 +1,152 @@
+#include "LoadStats.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+// replaces every form of the global allocator so allocations can be attributed to a load, linked only into
+// the benchmarks and tools, never part of the library objects
+namespace{
+    void *Allocate(std::size_t size){
+        CLoadStatsRecorder::CountAllocation(size);
+        if(size == 0){
+            size = 1;
+        }
+        void *Pointer;
+        while(!(Pointer = std::malloc(size))){
+            std::new_handler Handler = std::get_new_handler();
+            if(!Handler){
+                throw std::bad_alloc();
+            }
+            Handler();
+        }
+        return Pointer;
+    }
+
+    void *AllocateAligned(std::size_t size, std::align_val_t alignment){
+        CLoadStatsRecorder::CountAllocation(size);
+        std::size_t Alignment = std::max(std::size_t(alignment), sizeof(void *));
+        // aligned_alloc wants a multiple of the alignment
+        size = (std::max<std::size_t>(size, 1) + Alignment - 1) / Alignment * Alignment;
+        void *Pointer;
+#if defined(_WIN32)
+        while(!(Pointer = _aligned_malloc(size, Alignment))){
+#else
+        while(!(Pointer = std::aligned_alloc(Alignment, size))){
+#endif
+            std::new_handler Handler = std::get_new_handler();
+            if(!Handler){
+                throw std::bad_alloc();
+            }
+            Handler();
+        }
+        return Pointer;
+    }
+
+    void FreeAligned(void *pointer) noexcept{
+#if defined(_WIN32)
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void *operator new(std::size_t size){
+    return Allocate(size);
+}
+
+void *operator new[](std::size_t size){
+    return Allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept{
+    try{
+        return Allocate(size);
+    }
+    catch(...){
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept{
+    try{
+        return Allocate(size);
+    }
+    catch(...){
+        return nullptr;
+    }
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment){
+    return AllocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment){
+    return AllocateAligned(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept{
+    try{
+        return AllocateAligned(size, alignment);
+    }
+    catch(...){
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept{
+    try{
+        return AllocateAligned(size, alignment);
+    }
+    catch(...){
+        return nullptr;
+    }
+}
+
+void operator delete(void *pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept{
+    FreeAligned(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept{
+    FreeAligned(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept{
+    FreeAligned(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept{
+    FreeAligned(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept{
+    FreeAligned(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept{
+    FreeAligned(pointer);
+}
@@ -1,5 +1,8 @@
 #include "CSVBusSystem.h" 
 #include "DSVReader.h"    
+#include "IDIndex.h"
+#include "NumberUtils.h"
+#include <algorithm>
 #include <memory>           //provides std::shared_ptr and std::make_shared for memory management
 #include <vector>           
 #include <string>           // thihs allows use for string:: stuff
@@ -50,54 +53,134 @@ public:
 
 struct CCSVBusSystem::SImplementation {
     std::vector<std::shared_ptr<SStop>> StopsByIndex;  //this stores the stops
-    std::unordered_map<TStopID, std::shared_ptr<SStop>> Stops; //stores the stops by ID 
     std::vector<std::shared_ptr<SRoute>> RoutesByIndex; 
     std::unordered_map<std::string, std::shared_ptr<SRoute>> Routes;  
+
+    // reverse indices in CSR layout, routes serving StopsByIndex[i] are StopRouteIndices[StopRouteOffsets[i] .. StopRouteOffsets[i + 1])
+    CIDIndex StopIndices;
+    std::vector<std::size_t> StopRouteOffsets;
+    std::vector<std::size_t> StopRouteIndices;
+    // stops at a node are NodeStopIndices[NodeStopOffsets[slot] .. NodeStopOffsets[slot + 1]) where slot = NodeSlots[node]
+    std::unordered_map<CStreetMap::TNodeID, std::size_t> NodeSlots;
+    std::vector<std::size_t> NodeStopOffsets;
+    std::vector<std::size_t> NodeStopIndices;
+    SParseErrors ParseErrors;
+
+    void BuildIndices() {
+        std::vector<TStopID> IDs(StopsByIndex.size());
+        for (std::size_t Index = 0; Index < StopsByIndex.size(); Index++) {
+            IDs[Index] = StopsByIndex[Index]->StopID;
+        }
+        StopIndices.Build(IDs.data(), IDs.size());
+
+        // the stops of every route resolved in one batch, route r's are RouteStops[RouteOffsets[r] .. RouteOffsets[r + 1])
+        std::vector<TStopID> RouteStopIDs;
+        std::vector<std::size_t> RouteOffsets(1, 0);
+        for (auto &Route : RoutesByIndex) {
+            RouteStopIDs.insert(RouteStopIDs.end(), Route->rStops.begin(), Route->rStops.end());
+            RouteOffsets.push_back(RouteStopIDs.size());
+        }
+        std::vector<std::size_t> RouteStops(RouteStopIDs.size());
+        StopIndices.Find(RouteStopIDs.data(), RouteStopIDs.size(), RouteStops.data());
+
+        // visits every (stop index, route index) pair once, even if a route passes a stop twice
+        auto ForEachStopRoute = [&](auto callback) {
+            std::vector<std::size_t> LastRoute(StopsByIndex.size(), RoutesByIndex.size());
+            for (std::size_t Route = 0; Route < RoutesByIndex.size(); Route++) {
+                for (std::size_t Offset = RouteOffsets[Route]; Offset < RouteOffsets[Route + 1]; Offset++) {
+                    std::size_t Stop = RouteStops[Offset];
+                    if (Stop != CIDIndex::NotFound && LastRoute[Stop] != Route) {
+                        LastRoute[Stop] = Route;
+                        callback(Stop, Route);
+                    }
+                }
+            }
+        };
+        StopRouteOffsets.assign(StopsByIndex.size() + 1, 0);
+        ForEachStopRoute([this](std::size_t stop, std::size_t) {
+            StopRouteOffsets[stop + 1]++;
+        });
+        for (std::size_t Index = 0; Index < StopsByIndex.size(); Index++) {
+            StopRouteOffsets[Index + 1] += StopRouteOffsets[Index];
+        }
+        StopRouteIndices.resize(StopRouteOffsets.back());
+        std::vector<std::size_t> RouteFill(StopRouteOffsets.begin(), StopRouteOffsets.end() - 1);
+        ForEachStopRoute([this, &RouteFill](std::size_t stop, std::size_t route) {
+            StopRouteIndices[RouteFill[stop]++] = route;
+        });
+
+        std::vector<std::size_t> Slots(StopsByIndex.size());
+        for (std::size_t Index = 0; Index < StopsByIndex.size(); Index++) {
+            auto Inserted = NodeSlots.emplace(StopsByIndex[Index]->NodeIDValue, NodeSlots.size());
+            Slots[Index] = Inserted.first->second;
+        }
+        NodeStopOffsets.assign(NodeSlots.size() + 1, 0);
+        for (auto Slot : Slots) {
+            NodeStopOffsets[Slot + 1]++;
+        }
+        for (std::size_t Slot = 0; Slot < NodeSlots.size(); Slot++) {
+            NodeStopOffsets[Slot + 1] += NodeStopOffsets[Slot];
+        }
+        NodeStopIndices.resize(StopsByIndex.size());
+        std::vector<std::size_t> Fill(NodeStopOffsets.begin(), NodeStopOffsets.end() - 1);
+        for (std::size_t Index = 0; Index < StopsByIndex.size(); Index++) {
+            NodeStopIndices[Fill[Slots[Index]]++] = Index;
+        }
+    }
 };
 
 // constructor for the bus system
-CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_ptr<CDSVReader> routesrc) {
+CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_ptr<CDSVReader> routesrc, SLoadStats *stats) {
     DImplementation = std::make_unique<SImplementation>();
     // check if data is valid first
     if (!stopsrc && !routesrc) {
         throw std::invalid_argument("Both stopsrc and routesrc are null");
     }
+    CLoadStatsRecorder Recorder(stats);
+    double Total = 0.0; // row splitting is subtracted from the whole read to leave the build time
+    double TokenizeBefore = stats ? stats->DTokenizeSeconds : 0.0;
+    CLoadPhaseTimer Timer(stats ? &Total : nullptr);
     std::vector<std::string> row;  
     if (stopsrc) {
+        stopsrc->SetStats(stats);
+        // a first row naming the columns is the header, they are then read by name wherever they sit
+        bool more = stopsrc->ReadRow(row);
+        if (more && stopsrc->SelectColumns(row, {"stop_id", "node_id"})) {
+            more = stopsrc->ReadRow(row);
+        }
         //read each row of the stop file with a while loop
-        while (stopsrc->ReadRow(row)) {
+        for (; more; more = stopsrc->ReadRow(row)) {
             // ensure sufficient columns exists
-            if (row.size() >= 2) {  
-                try {
-                    auto stop = std::make_shared<SStop>();
-                    stop->StopID = std::stoul(row[0]);  
-                    stop->NodeIDValue = std::stoul(row[1]);  
-                    DImplementation->Stops[stop->StopID] = stop; 
-                    DImplementation->StopsByIndex.push_back(stop);  
-                } catch (const std::exception& e) {
-                    std::cerr << "exception caught -  " << e.what() << "\n";
-                }
+            // rows whose ids do not decode are skipped and counted
+            TStopID stopID;
+            CStreetMap::TNodeID nodeID;
+            if (row.size() >= 2 && NumberUtils::ToUInt64(row[0], stopID, &DImplementation->ParseErrors) && NumberUtils::ToUInt64(row[1], nodeID, &DImplementation->ParseErrors)) {
+                auto stop = std::make_shared<SStop>();
+                stop->StopID = stopID;
+                stop->NodeIDValue = nodeID;
+                DImplementation->StopsByIndex.push_back(stop);  
             }
         }
     }
 
     if (routesrc) {
+        routesrc->SetStats(stats);
         std::unordered_map<std::string, std::shared_ptr<SRoute>> tempRoutes;  
-        while (routesrc->ReadRow(row)) {  
-            if (row.size() >= 2) {  // i have ot make sure there is enmnough row s first
-                try {
-                    std::string routeName = row[0];  //first one should be routename
-                    TStopID stopID = std::stoul(row[1]);  //second one should be the stop id
-                    auto& route = tempRoutes[routeName];  
-                    if (!route) {
-                        route = std::make_shared<SRoute>();
-                        route->RouteName = routeName;
-                    }
-                    route->rStops.push_back(stopID);  
-                } catch (const std::exception& e) {
-                    //handle error
-                    std::cerr << "exception caught -  " << e.what() << "\n";
+        bool more = routesrc->ReadRow(row);
+        if (more && routesrc->SelectColumns(row, {"route", "stop_id"})) {
+            more = routesrc->ReadRow(row);
+        }
+        for (; more; more = routesrc->ReadRow(row)) {  
+            TStopID stopID;
+            // i have ot make sure there is enmnough row s first, the second one should be the stop id
+            if (row.size() >= 2 && NumberUtils::ToUInt64(row[1], stopID, &DImplementation->ParseErrors)) {
+                std::string routeName = row[0];  //first one should be routename
+                auto& route = tempRoutes[routeName];  
+                if (!route) {
+                    route = std::make_shared<SRoute>();
+                    route->RouteName = routeName;
                 }
+                route->rStops.push_back(stopID);  
             }
         }
 
@@ -106,6 +189,22 @@ CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_pt
             DImplementation->RoutesByIndex.push_back(pair.second);  
         }
     }
+    Timer.Stop();
+    if (stopsrc) {
+        stopsrc->SetStats(nullptr);
+    }
+    if (routesrc) {
+        routesrc->SetStats(nullptr);
+    }
+    {
+        CLoadPhaseTimer IndexTimer(stats ? &stats->DIndexSeconds : nullptr);
+        DImplementation->BuildIndices();
+    }
+    if (stats) {
+        stats->DBuildSeconds += Total - (stats->DTokenizeSeconds - TokenizeBefore);
+        stats->DStopCount += DImplementation->StopsByIndex.size();
+        stats->DRouteCount += DImplementation->RoutesByIndex.size();
+    }
 }
 
 
@@ -125,11 +224,8 @@ std::size_t CCSVBusSystem::RouteCount() const noexcept {
 
 // return a stop by its ID
 std::shared_ptr<CBusSystem::SStop> CCSVBusSystem::StopByID(TStopID id) const noexcept {
-    auto temp = DImplementation->Stops.find(id);
-    if (temp != DImplementation->Stops.end()) {
-        return temp->second;
-    }
-    return nullptr;
+    std::size_t Index = DImplementation->StopIndices.Find(id);
+    return Index == CIDIndex::NotFound ? nullptr : DImplementation->StopsByIndex[Index];
 }
 
 // return a route by index
@@ -156,6 +252,91 @@ std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::RouteByName(const std::string
     return nullptr;
 }
 
+// return the number of distinct routes serving a stop
+std::size_t CCSVBusSystem::StopRouteCount(TStopID id) const noexcept {
+    std::size_t Index = DImplementation->StopIndices.Find(id);
+    if (Index == CIDIndex::NotFound) {
+        return 0;
+    }
+    return DImplementation->StopRouteOffsets[Index + 1] - DImplementation->StopRouteOffsets[Index];
+}
+
+std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::StopRouteByIndex(TStopID id, std::size_t index) const noexcept {
+    if (index >= StopRouteCount(id)) {
+        return nullptr;
+    }
+    std::size_t Offset = DImplementation->StopRouteOffsets[DImplementation->StopIndices.Find(id)];
+    return DImplementation->RoutesByIndex[DImplementation->StopRouteIndices[Offset + index]];
+}
+
+// return the number of stops placed at a street map node
+std::size_t CCSVBusSystem::NodeStopCount(CStreetMap::TNodeID id) const noexcept {
+    auto Search = DImplementation->NodeSlots.find(id);
+    if (Search == DImplementation->NodeSlots.end()) {
+        return 0;
+    }
+    return DImplementation->NodeStopOffsets[Search->second + 1] - DImplementation->NodeStopOffsets[Search->second];
+}
+
+std::shared_ptr<CBusSystem::SStop> CCSVBusSystem::NodeStopByIndex(CStreetMap::TNodeID id, std::size_t index) const noexcept {
+    if (index >= NodeStopCount(id)) {
+        return nullptr;
+    }
+    std::size_t Offset = DImplementation->NodeStopOffsets[DImplementation->NodeSlots.find(id)->second];
+    return DImplementation->StopsByIndex[DImplementation->NodeStopIndices[Offset + index]];
+}
+
+
+const CBusSystem::SStop *CCSVBusSystem::StopHandleByIndex(std::size_t index) const noexcept {
+    return index < DImplementation->StopsByIndex.size() ? DImplementation->StopsByIndex[index].get() : nullptr;
+}
+
+const CBusSystem::SStop *CCSVBusSystem::StopHandleByID(TStopID id) const noexcept {
+    std::size_t Index = DImplementation->StopIndices.Find(id);
+    return Index == CIDIndex::NotFound ? nullptr : DImplementation->StopsByIndex[Index].get();
+}
+
+const CBusSystem::SRoute *CCSVBusSystem::RouteHandleByIndex(std::size_t index) const noexcept {
+    return index < DImplementation->RoutesByIndex.size() ? DImplementation->RoutesByIndex[index].get() : nullptr;
+}
+
+const CBusSystem::SRoute *CCSVBusSystem::RouteHandleByName(const std::string &name) const noexcept {
+    auto Search = DImplementation->Routes.find(name);
+    return Search == DImplementation->Routes.end() ? nullptr : Search->second.get();
+}
+
+const CBusSystem::SRoute *CCSVBusSystem::StopRouteHandleByIndex(TStopID id, std::size_t index) const noexcept {
+    if (index >= StopRouteCount(id)) {
+        return nullptr;
+    }
+    std::size_t Offset = DImplementation->StopRouteOffsets[DImplementation->StopIndices.Find(id)];
+    return DImplementation->RoutesByIndex[DImplementation->StopRouteIndices[Offset + index]].get();
+}
+
+const CBusSystem::SStop *CCSVBusSystem::NodeStopHandleByIndex(CStreetMap::TNodeID id, std::size_t index) const noexcept {
+    if (index >= NodeStopCount(id)) {
+        return nullptr;
+    }
+    std::size_t Offset = DImplementation->NodeStopOffsets[DImplementation->NodeSlots.find(id)->second];
+    return DImplementation->StopsByIndex[DImplementation->NodeStopIndices[Offset + index]].get();
+}
+
+void CCSVBusSystem::StopIndicesByID(const TStopID *ids, std::size_t count, std::size_t *indices) const {
+    DImplementation->StopIndices.Find(ids, count, indices);
+    std::replace(indices, indices + count, CIDIndex::NotFound, DImplementation->StopsByIndex.size());
+}
+
+void CCSVBusSystem::StopHandlesByID(const TStopID *ids, std::size_t count, const CBusSystem::SStop **stops) const {
+    std::vector<std::size_t> Indices(count);
+    StopIndicesByID(ids, count, Indices.data());
+    for (std::size_t Index = 0; Index < count; Index++) {
+        stops[Index] = StopHandleByIndex(Indices[Index]);
+    }
+}
+
+const SParseErrors &CCSVBusSystem::ParseErrors() const noexcept {
+    return DImplementation->ParseErrors;
+}
 
 std::ostream &operator<<(std::ostream &os, const CCSVBusSystem &bussystem) {
     os << "StopCount: " << std::to_string(bussystem.StopCount()) << "\n";
@@ -163,7 +344,7 @@ std::ostream &operator<<(std::ostream &os, const CCSVBusSystem &bussystem) {
     //overload from #include iostream
     
     for (size_t i = 0; i < bussystem.StopCount(); i++) {
-        auto stop = bussystem.StopByIndex(i);
+        auto stop = bussystem.StopHandleByIndex(i);
         if (stop) {
             os << "Index " << std::to_string(i) << " ID: " << std::to_string(stop->ID()) <<
                   " NodeID: " << std::to_string(stop->NodeID()) << "\n";
@@ -171,7 +352,7 @@ std::ostream &operator<<(std::ostream &os, const CCSVBusSystem &bussystem) {
     }
     
     for (size_t i = 0; i < bussystem.RouteCount(); i++) {
-        auto route = bussystem.RouteByIndex(i);
+        auto route = bussystem.RouteHandleByIndex(i);
         if (route) {
             os << "Route Index " << std::to_string(i) << " Name: " << route->Name() +
                   " StopCount: " << std::to_string(route->StopCount()) << "\n";
@@ -1,50 +1,130 @@
 #include "DSVReader.h"
 #include "DataSource.h"
+#include <algorithm>
+#include <limits>
 
 struct CDSVReader::SImplementation {
     std::shared_ptr<CDataSource> source;
     char Delimiter;
+    SLoadStats *Stats = nullptr;
 
     SImplementation(std::shared_ptr<CDataSource> src, char delimiter) : source(src), Delimiter(delimiter) {
     }
 
-    bool ReadRow(std::vector<std::string> &row) {
+    static constexpr std::size_t NoSlot = std::numeric_limits<std::size_t>::max();
+    // slot in the returned row of each column of the file, NoSlot for columns that are skipped,
+    // empty when every column is returned
+    std::vector<std::size_t> Projection;
+    std::size_t ProjectedCount = 0;
 
-        row.clear();
-        std::string field;
-        char c;
+    // the source is pulled a block at a time and fields are cut out of the block, BufferIndex is the next unread byte
+    static constexpr std::size_t BlockSize = 1 << 14;
+    std::vector<char> Buffer;
+    std::size_t BufferIndex = 0;
+
+    bool Fill() {
+        BufferIndex = 0;
+        source->Read(Buffer, BlockSize);
+        if (Stats) {
+            Stats->DBytesRead += Buffer.size();
+        }
+        return !Buffer.empty();
+    }
+
+    bool End() const {
+        return BufferIndex == Buffer.size() && source->End();
+    }
+
+    bool ReadRow(std::vector<std::string> &row) {
+        bool projected = !Projection.empty();
+        std::size_t column = 0;
+        // where the characters of the current field go, fields are built in place in the row
+        // and skipped fields are scanned but not copied
+        auto target = [&]() -> std::string * {
+            if (!projected) {
+                row.emplace_back();
+                return &row.back();
+            }
+            return column < Projection.size() && Projection[column] != NoSlot ? &row[Projection[column]] : nullptr;
+        };
+        if (projected) {
+            row.resize(ProjectedCount);
+            for (auto &cell : row) {
+                cell.clear();
+            }
+        } else {
+            row.clear();
+        }
+        std::string *current = target();
         bool quoted = false;
+        bool any = false; // whether the row has consumed anything
+        CLoadPhaseTimer Timer(Stats ? &Stats->DTokenizeSeconds : nullptr);
 
-        while (!source->End()) {
-            source->Get(c);
+        while (BufferIndex < Buffer.size() || Fill()) {
+            any = true;
+            const char *data = Buffer.data();
+            std::size_t size = Buffer.size();
+            // runs of ordinary characters are copied in one go, quoted runs end only at a quote
+            std::size_t begin = BufferIndex;
+            if (quoted) {
+                while (BufferIndex < size && data[BufferIndex] != '"') {
+                    BufferIndex++;
+                }
+            } else {
+                while (BufferIndex < size && data[BufferIndex] != '"' && data[BufferIndex] != Delimiter && data[BufferIndex] != '\n') {
+                    BufferIndex++;
+                }
+            }
+            if (current) {
+                current->append(data + begin, BufferIndex - begin);
+            }
+            if (BufferIndex == size) {
+                continue;
+            }
+            char c = data[BufferIndex++];
 
             if (c == '"'){
-                char nc;
-                bool peeked = source->Peek(nc);
-                if (peeked == true && nc == '"'){
-                    source->Get(nc);
-                    field += '"';
-                } else if (quoted == false) {
-                    quoted = true;
+                // a doubled quote is a literal one, anything else opens or closes quoting
+                if ((BufferIndex < Buffer.size() || Fill()) && Buffer[BufferIndex] == '"'){
+                    BufferIndex++;
+                    if (current) {
+                        *current += '"';
+                    }
                 } else {
-                    quoted = false;
+                    quoted = !quoted;
                 }
-            } else if ((c == Delimiter || c == '\n')  && !quoted){
-                row.push_back(field);
-                field.clear();
+            } else {
                 if (c == '\n') {
                     return true;
                 }
-            } else { 
-                field += c;
+                column++;
+                current = target();
             }
         }
-        if (!field.empty() || !row.empty()) { 
-            row.push_back(field);
+        if (projected) {
+            return any;
+        }
+        // nothing but an empty last field means there was no row left
+        if (row.size() > 1 || !row.back().empty()) {
             return true;
         }
+        row.clear();
         return false;
     }
+
+    bool SelectColumns(const std::vector<std::string> &header, const std::vector<std::string> &columns) {
+        std::vector<std::size_t> projection(header.size(), NoSlot);
+        for (std::size_t slot = 0; slot < columns.size(); slot++) {
+            auto found = std::find(header.begin(), header.end(), columns[slot]);
+            if (found == header.end() || projection[found - header.begin()] != NoSlot) {
+                return false;
+            }
+            projection[found - header.begin()] = slot;
+        }
+        Projection = std::move(projection);
+        ProjectedCount = columns.size();
+        return true;
+    }
 };
 
 CDSVReader::CDSVReader(std::shared_ptr< CDataSource > src, char delimiter) : DImplementation(std::make_unique<SImplementation>(src, delimiter)) {
@@ -53,9 +133,28 @@ CDSVReader::CDSVReader(std::shared_ptr< CDataSource > src, char delimiter) : DIm
 CDSVReader::~CDSVReader() = default;
 
 bool CDSVReader::End() const {
-    return DImplementation->source->End();
+    return DImplementation->End();
 }
 
 bool CDSVReader::ReadRow(std::vector< std::string > &row) {
    return DImplementation->ReadRow(row);
 }
+
+void CDSVReader::SetStats(SLoadStats *stats) noexcept {
+    DImplementation->Stats = stats;
+}
+
+bool CDSVReader::SelectColumns(const std::vector< std::string > &header, const std::vector< std::string > &columns) {
+    return !columns.empty() && DImplementation->SelectColumns(header, columns);
+}
+
+bool CDSVReader::ReadHeader(const std::vector< std::string > &columns) {
+    std::vector< std::string > Header;
+    auto Previous = std::move(DImplementation->Projection);
+    DImplementation->Projection.clear();
+    if (DImplementation->ReadRow(Header) && SelectColumns(Header, columns)) {
+        return true;
+    }
+    DImplementation->Projection = std::move(Previous);
+    return false;
+}
@@ -0,0 +1,169 @@
+#include "DSVRowIndex.h"
+#include <algorithm>
+#include "DSVWriter.h"
+#include "NumberUtils.h"
+
+// fnv-1a over the first and last block, a cheap check that catches a source rewritten to the same size
+static bool SourceHash(CSeekableDataSource &src, uint64_t &hash){
+    const std::size_t BlockSize = 4096;
+    std::size_t Size = src.Size();
+    std::size_t Starts[2] = {0, Size > BlockSize ? Size - BlockSize : 0};
+    hash = 14695981039346656037ull;
+    std::vector<char> Buffer;
+    for(std::size_t Start : Starts){
+        std::size_t Remaining = std::min(BlockSize, Size - Start);
+        if(!src.Seek(Start)){
+            return false;
+        }
+        while(Remaining){
+            if(!src.Read(Buffer, Remaining)){
+                return false;
+            }
+            for(char Char : Buffer){
+                hash = (hash ^ uint8_t(Char)) * 1099511628211ull;
+            }
+            Remaining -= Buffer.size();
+        }
+    }
+    return true;
+}
+
+CDSVRowIndex::CDSVRowIndex(std::size_t interval) : DInterval(interval ? interval : 1){
+}
+
+bool CDSVRowIndex::Build(CSeekableDataSource &src){
+    DRowCount = 0;
+    DOffsets.clear();
+    DSourceSize = src.Size();
+    if(!SourceHash(src, DSourceHash) || !src.Seek(0)){
+        return false;
+    }
+    std::vector<char> Buffer;
+    std::size_t Offset = 0;
+    bool Quoted = false;
+    bool RowOpen = false; // bytes seen since the last row ended
+    while(src.Read(Buffer, 1 << 16)){
+        for(char Char : Buffer){
+            if(!RowOpen){
+                if(DRowCount % DInterval == 0){
+                    DOffsets.push_back(Offset);
+                }
+                RowOpen = true;
+            }
+            // a doubled quote toggles twice, leaving the state as the reader would
+            if(Char == '"'){
+                Quoted = !Quoted;
+            }
+            else if(Char == '\n' && !Quoted){
+                DRowCount++;
+                RowOpen = false;
+            }
+            Offset++;
+        }
+    }
+    if(RowOpen){
+        DRowCount++;
+    }
+    return true;
+}
+
+bool CDSVRowIndex::Save(std::shared_ptr< CDataSink > sink) const{
+    CDSVWriter Writer(sink, ',');
+    if(!Writer.WriteRow({"dsvrowindex", std::to_string(DInterval), std::to_string(DRowCount), std::to_string(DSourceSize), std::to_string(DSourceHash)})){
+        return false;
+    }
+    for(auto Offset : DOffsets){
+        if(!Writer.WriteRow({std::to_string(Offset)})){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CDSVRowIndex::Load(std::shared_ptr< CDataSource > src, CSeekableDataSource &indexed){
+    CDSVReader Reader(src, ',');
+    std::vector< std::string > Row;
+    uint64_t Interval, RowCount, SourceSize, SavedHash, Hash;
+    if(!Reader.ReadRow(Row) || Row.size() != 5 || Row[0] != "dsvrowindex" || !NumberUtils::ToUInt64(Row[1], Interval) || !Interval
+        || !NumberUtils::ToUInt64(Row[2], RowCount) || !NumberUtils::ToUInt64(Row[3], SourceSize) || SourceSize != indexed.Size()
+        || !NumberUtils::ToUInt64(Row[4], SavedHash) || !SourceHash(indexed, Hash) || Hash != SavedHash){
+        return false;
+    }
+    std::vector< std::size_t > Offsets;
+    while(Reader.ReadRow(Row)){
+        uint64_t Offset;
+        if(Row.size() != 1 || !NumberUtils::ToUInt64(Row[0], Offset) || Offset >= SourceSize || (!Offsets.empty() && Offset <= Offsets.back())){
+            return false;
+        }
+        Offsets.push_back(Offset);
+    }
+    if(Offsets.size() != (RowCount + Interval - 1) / Interval){
+        return false;
+    }
+    DInterval = Interval;
+    DRowCount = RowCount;
+    DSourceSize = SourceSize;
+    DSourceHash = Hash;
+    DOffsets = std::move(Offsets);
+    return true;
+}
+
+std::size_t CDSVRowIndex::Interval() const noexcept{
+    return DInterval;
+}
+
+std::size_t CDSVRowIndex::RowCount() const noexcept{
+    return DRowCount;
+}
+
+bool CDSVRowIndex::Checkpoint(std::size_t row, std::size_t &checkpointrow, std::size_t &offset) const noexcept{
+    if(row > DRowCount){
+        return false;
+    }
+    if(row == DRowCount){
+        // just past the last row, which reads as the end
+        checkpointrow = row;
+        offset = DSourceSize;
+        return true;
+    }
+    checkpointrow = row - row % DInterval;
+    offset = DOffsets[row / DInterval];
+    return true;
+}
+
+CIndexedDSVReader::CIndexedDSVReader(std::shared_ptr< CSeekableDataSource > src, char delimiter, std::shared_ptr< const CDSVRowIndex > index) : DSource(src), DIndex(index), DDelimiter(delimiter){
+    SeekRow(0);
+}
+
+CIndexedDSVReader::~CIndexedDSVReader() = default;
+
+bool CIndexedDSVReader::SeekRow(std::size_t row){
+    std::size_t CheckpointRow, Offset;
+    if(!DSource || !DIndex || !DIndex->Checkpoint(row, CheckpointRow, Offset) || !DSource->Seek(Offset)){
+        return false;
+    }
+    // the reader buffers ahead, so each seek starts a fresh one at the checkpoint
+    DReader = std::make_unique<CDSVReader>(DSource, DDelimiter);
+    DRow = CheckpointRow;
+    std::vector< std::string > Skipped;
+    while(DRow < row && DReader->ReadRow(Skipped)){
+        DRow++;
+    }
+    return DRow == row;
+}
+
+std::size_t CIndexedDSVReader::Row() const noexcept{
+    return DRow;
+}
+
+bool CIndexedDSVReader::End() const{
+    return !DReader || DReader->End();
+}
+
+bool CIndexedDSVReader::ReadRow(std::vector< std::string > &row){
+    if(!DReader || !DReader->ReadRow(row)){
+        return false;
+    }
+    DRow++;
+    return true;
+}
@@ -0,0 +1,214 @@
+#include "DSVTable.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+struct CDSVTable::SImplementation {
+    struct SColumn {
+        std::string Name;
+        EType Type;
+        std::size_t Source; // position of the column in the file rows
+        std::vector<int64_t> Ints;
+        std::vector<double> Doubles;
+        std::vector<uint32_t> Codes;
+        std::vector<std::string> Dictionary;
+        std::unordered_map<std::string, uint32_t> Lookup;
+        std::vector<uint8_t> Valid;
+        std::size_t Nulls = 0;
+    };
+
+    std::vector<SColumn> Columns;
+    std::size_t Rows = 0;
+    SParseErrors Errors;
+    const std::string Empty;
+
+    void AddColumn(const std::string &name, EType type, std::size_t source) {
+        Columns.emplace_back();
+        Columns.back().Name = name;
+        Columns.back().Type = type;
+        Columns.back().Source = source;
+    }
+
+    void Append(SColumn &column, const std::string *cell) {
+        bool valid = cell && !cell->empty();
+        if (column.Type == EType::Int64) {
+            int64_t value = 0;
+            valid = valid && NumberUtils::ToInt64(*cell, value, &Errors);
+            column.Ints.push_back(value);
+        } else if (column.Type == EType::Double) {
+            double value = 0.0;
+            valid = valid && NumberUtils::ToDouble(*cell, value, &Errors);
+            column.Doubles.push_back(value);
+        } else {
+            uint32_t code = 0;
+            if (valid) {
+                auto inserted = column.Lookup.emplace(*cell, uint32_t(column.Dictionary.size()));
+                if (inserted.second) {
+                    column.Dictionary.push_back(*cell);
+                }
+                code = inserted.first->second;
+            }
+            column.Codes.push_back(code);
+        }
+        column.Valid.push_back(valid);
+        column.Nulls += !valid;
+    }
+
+    void Append(const std::vector<std::string> &row) {
+        for (auto &column : Columns) {
+            Append(column, column.Source < row.size() ? &row[column.Source] : nullptr);
+        }
+        Rows++;
+    }
+
+    // header names, or positions when there is no header, in which case the first row is data and is returned
+    std::vector<std::string> Names(CDSVReader &src, bool header, std::vector<std::string> &first, bool &hasfirst) {
+        std::vector<std::string> names;
+        hasfirst = src.ReadRow(first);
+        if (header) {
+            names = first;
+            hasfirst = false;
+        } else if (hasfirst) {
+            for (std::size_t index = 0; index < first.size(); index++) {
+                names.push_back(std::to_string(index));
+            }
+        }
+        return names;
+    }
+
+    void Infer(CDSVReader &src, bool header, std::size_t samplerows) {
+        std::vector<std::string> first;
+        bool hasfirst;
+        auto names = Names(src, header, first, hasfirst);
+        // sampled rows are held until the types are known, then loaded like the rest
+        std::vector<std::vector<std::string>> sample;
+        if (hasfirst) {
+            sample.push_back(std::move(first));
+        }
+        std::vector<std::string> row;
+        while (sample.size() < samplerows && src.ReadRow(row)) {
+            sample.push_back(row);
+        }
+        for (std::size_t index = 0; index < names.size(); index++) {
+            // a column with nothing in the sample could hold anything, so it is kept as strings
+            bool ints = true, doubles = true, seen = false;
+            for (auto &sampled : sample) {
+                if (index >= sampled.size() || sampled[index].empty()) {
+                    continue;
+                }
+                seen = true;
+                int64_t intvalue;
+                double doublevalue;
+                ints = ints && NumberUtils::ToInt64(sampled[index], intvalue);
+                doubles = doubles && (ints || NumberUtils::ToDouble(sampled[index], doublevalue));
+            }
+            AddColumn(names[index], !seen ? EType::String : ints ? EType::Int64 : doubles ? EType::Double : EType::String, index);
+        }
+        for (auto &sampled : sample) {
+            Append(sampled);
+        }
+        while (src.ReadRow(row)) {
+            Append(row);
+        }
+    }
+
+    void Load(CDSVReader &src, const std::vector<SColumnSchema> &schema, bool header) {
+        std::vector<std::string> first;
+        bool hasfirst;
+        auto names = Names(src, header, first, hasfirst);
+        for (std::size_t index = 0; index < schema.size(); index++) {
+            std::size_t source = index;
+            if (header) {
+                // a column missing from the header is all null
+                source = std::find(names.begin(), names.end(), schema[index].DName) - names.begin();
+                source = source < names.size() ? source : std::numeric_limits<std::size_t>::max();
+            }
+            AddColumn(schema[index].DName, schema[index].DType, source);
+        }
+        if (hasfirst) {
+            Append(first);
+        }
+        std::vector<std::string> row;
+        while (src.ReadRow(row)) {
+            Append(row);
+        }
+    }
+
+    const SColumn *Column(std::size_t column, EType type) const noexcept {
+        return column < Columns.size() && Columns[column].Type == type ? &Columns[column] : nullptr;
+    }
+};
+
+CDSVTable::CDSVTable(std::shared_ptr<CDSVReader> src, bool header, std::size_t samplerows) : DImplementation(std::make_unique<SImplementation>()) {
+    if (src) {
+        DImplementation->Infer(*src, header, std::max<std::size_t>(samplerows, 1));
+    }
+}
+
+CDSVTable::CDSVTable(std::shared_ptr<CDSVReader> src, const std::vector<SColumnSchema> &schema, bool header) : DImplementation(std::make_unique<SImplementation>()) {
+    if (src) {
+        DImplementation->Load(*src, schema, header);
+    }
+}
+
+CDSVTable::~CDSVTable() = default;
+
+std::size_t CDSVTable::RowCount() const noexcept {
+    return DImplementation->Rows;
+}
+
+std::size_t CDSVTable::ColumnCount() const noexcept {
+    return DImplementation->Columns.size();
+}
+
+std::size_t CDSVTable::ColumnIndex(const std::string &name) const noexcept {
+    auto &Columns = DImplementation->Columns;
+    return std::find_if(Columns.begin(), Columns.end(), [&name](const SImplementation::SColumn &column) {
+        return column.Name == name;
+    }) - Columns.begin();
+}
+
+const std::string &CDSVTable::ColumnName(std::size_t column) const noexcept {
+    return column < ColumnCount() ? DImplementation->Columns[column].Name : DImplementation->Empty;
+}
+
+CDSVTable::EType CDSVTable::ColumnType(std::size_t column) const noexcept {
+    return column < ColumnCount() ? DImplementation->Columns[column].Type : EType::String;
+}
+
+const uint8_t *CDSVTable::ValidColumn(std::size_t column) const noexcept {
+    return column < ColumnCount() ? DImplementation->Columns[column].Valid.data() : nullptr;
+}
+
+std::size_t CDSVTable::NullCount(std::size_t column) const noexcept {
+    return column < ColumnCount() ? DImplementation->Columns[column].Nulls : 0;
+}
+
+const int64_t *CDSVTable::Int64Column(std::size_t column) const noexcept {
+    auto Column = DImplementation->Column(column, EType::Int64);
+    return Column ? Column->Ints.data() : nullptr;
+}
+
+const double *CDSVTable::DoubleColumn(std::size_t column) const noexcept {
+    auto Column = DImplementation->Column(column, EType::Double);
+    return Column ? Column->Doubles.data() : nullptr;
+}
+
+const uint32_t *CDSVTable::StringCodes(std::size_t column) const noexcept {
+    auto Column = DImplementation->Column(column, EType::String);
+    return Column ? Column->Codes.data() : nullptr;
+}
+
+std::size_t CDSVTable::DictionarySize(std::size_t column) const noexcept {
+    auto Column = DImplementation->Column(column, EType::String);
+    return Column ? Column->Dictionary.size() : 0;
+}
+
+const std::string &CDSVTable::DictionaryValue(std::size_t column, uint32_t code) const noexcept {
+    auto Column = DImplementation->Column(column, EType::String);
+    return Column && code < Column->Dictionary.size() ? Column->Dictionary[code] : DImplementation->Empty;
+}
+
+const SParseErrors &CDSVTable::ParseErrors() const noexcept {
+    return DImplementation->Errors;
+}
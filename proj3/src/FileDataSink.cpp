@@ -0,0 +1,30 @@
+#include "FileDataSink.h"
+
+CFileDataSink::CFileDataSink(const std::string &filename) : DFile(std::fopen(filename.c_str(), "wb")){
+    if(DFile){
+        // writers put one character at a time, so give stdio a large buffer to batch them
+        std::setvbuf(DFile, nullptr, _IOFBF, 1 << 20);
+    }
+}
+
+CFileDataSink::~CFileDataSink(){
+    if(DFile){
+        std::fclose(DFile);
+    }
+}
+
+bool CFileDataSink::IsOpen() const noexcept{
+    return DFile != nullptr;
+}
+
+bool CFileDataSink::Flush() noexcept{
+    return DFile && std::fflush(DFile) == 0;
+}
+
+bool CFileDataSink::Put(const char &ch) noexcept{
+    return DFile && std::fputc(ch, DFile) != EOF;
+}
+
+bool CFileDataSink::Write(const std::vector<char> &buf) noexcept{
+    return DFile && std::fwrite(buf.data(), 1, buf.size(), DFile) == buf.size();
+}
@@ -0,0 +1,100 @@
+#include "FileDataSource.h"
+
+namespace{
+    // 64 bit offsets, so sources past 2 GB seek correctly on every target
+#if defined(_WIN32)
+    int SeekFile(std::FILE *file, std::size_t offset, int origin) noexcept{
+        return _fseeki64(file, __int64(offset), origin);
+    }
+
+    std::size_t TellFile(std::FILE *file) noexcept{
+        return std::size_t(_ftelli64(file));
+    }
+#else
+    int SeekFile(std::FILE *file, std::size_t offset, int origin) noexcept{
+        return fseeko(file, off_t(offset), origin);
+    }
+
+    std::size_t TellFile(std::FILE *file) noexcept{
+        return std::size_t(ftello(file));
+    }
+#endif
+}
+
+CFileDataSource::CFileDataSource(const std::string &filename) : DFile(std::fopen(filename.c_str(), "rb")), DSize(0){
+    if(DFile && SeekFile(DFile, 0, SEEK_END) == 0){
+        DSize = TellFile(DFile);
+        SeekFile(DFile, 0, SEEK_SET);
+    }
+    if(DFile){
+        // readers take one character at a time, so give stdio a large buffer to batch them
+        std::setvbuf(DFile, nullptr, _IOFBF, 1 << 20);
+    }
+}
+
+CFileDataSource::~CFileDataSource(){
+    if(DFile){
+        std::fclose(DFile);
+    }
+}
+
+bool CFileDataSource::IsOpen() const noexcept{
+    return DFile != nullptr;
+}
+
+bool CFileDataSource::End() const noexcept{
+    if(!DFile){
+        return true;
+    }
+    // end of file is only flagged after a read fails, so look one character ahead
+    int TempChar = std::getc(DFile);
+    if(TempChar == EOF){
+        return true;
+    }
+    std::ungetc(TempChar, DFile);
+    return false;
+}
+
+bool CFileDataSource::Get(char &ch) noexcept{
+    if(!DFile){
+        return false;
+    }
+    int TempChar = std::getc(DFile);
+    if(TempChar == EOF){
+        return false;
+    }
+    ch = char(TempChar);
+    return true;
+}
+
+bool CFileDataSource::Peek(char &ch) noexcept{
+    if(!DFile){
+        return false;
+    }
+    int TempChar = std::getc(DFile);
+    if(TempChar == EOF){
+        return false;
+    }
+    std::ungetc(TempChar, DFile);
+    ch = char(TempChar);
+    return true;
+}
+
+bool CFileDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    buf.resize(count);
+    std::size_t Length = DFile ? std::fread(buf.data(), 1, count, DFile) : 0;
+    buf.resize(Length);
+    return !buf.empty();
+}
+
+std::size_t CFileDataSource::Size() const noexcept{
+    return DSize;
+}
+
+std::size_t CFileDataSource::Tell() const noexcept{
+    return DFile ? TellFile(DFile) : 0;
+}
+
+bool CFileDataSource::Seek(std::size_t position) noexcept{
+    return DFile && position <= DSize && SeekFile(DFile, position, SEEK_SET) == 0;
+}
@@ -0,0 +1,284 @@
+#include "GeographicUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace GeographicUtils
+{
+
+    namespace
+    {
+        // M_PI is not standard C++ and is hidden by strict modes on some toolchains
+        constexpr double Pi = 3.14159265358979323846;
+        const double RadiansPerDegree = Pi / 180.0;
+        const double RadiansPerUnit = RadiansPerDegree / FixedUnitsPerDegree;
+        // points are converted and reduced a block at a time so each step is a plain loop over arrays
+        const std::size_t BlockSize = 64;
+
+        struct SBlock
+        {
+            double Latitudes[BlockSize];
+            double Longitudes[BlockSize];
+            double First[BlockSize];
+            double Second[BlockSize];
+        };
+
+        // fills the block with the points in radians
+        void Load(const TLocation *points, std::size_t count, SBlock &block) noexcept
+        {
+            for (std::size_t Index = 0; Index < count; Index++)
+            {
+                block.Latitudes[Index] = points[Index].first * RadiansPerDegree;
+                block.Longitudes[Index] = points[Index].second * RadiansPerDegree;
+            }
+        }
+
+        void Load(const SFixedLocation *points, std::size_t count, SBlock &block) noexcept
+        {
+            std::size_t Index = 0;
+#if defined(__SSE2__)
+            // two points per load, the shuffle moves both latitudes to the low half and both longitudes to the high half
+            const __m128d scale = _mm_set1_pd(RadiansPerUnit);
+            for (; Index + 2 <= count; Index += 2)
+            {
+                __m128i pair = _mm_loadu_si128(reinterpret_cast<const __m128i *>(points + Index));
+                pair = _mm_shuffle_epi32(pair, _MM_SHUFFLE(3, 1, 2, 0));
+                _mm_storeu_pd(block.Latitudes + Index, _mm_mul_pd(_mm_cvtepi32_pd(pair), scale));
+                _mm_storeu_pd(block.Longitudes + Index, _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(pair, pair)), scale));
+            }
+#endif
+            for (; Index < count; Index++)
+            {
+                block.Latitudes[Index] = points[Index].DLatitude * RadiansPerUnit;
+                block.Longitudes[Index] = points[Index].DLongitude * RadiansPerUnit;
+            }
+        }
+
+        // values[i] = min(limit, sqrt(values[i])), the haversine term can round just past 1 for antipodal points
+        void Sqrt(double *values, std::size_t count, double limit) noexcept
+        {
+            std::size_t Index = 0;
+#if defined(__SSE2__)
+            const __m128d bound = _mm_set1_pd(limit);
+            for (; Index + 2 <= count; Index += 2)
+            {
+                _mm_storeu_pd(values + Index, _mm_min_pd(_mm_sqrt_pd(_mm_loadu_pd(values + Index)), bound));
+            }
+#endif
+            for (; Index < count; Index++)
+            {
+                values[Index] = std::min(limit, std::sqrt(values[Index]));
+            }
+        }
+
+        double NormalizeBearing(double radians) noexcept
+        {
+            return std::fmod(radians / RadiansPerDegree + 360.0, 360.0);
+        }
+
+        template <typename TPoint, typename TKernel>
+        void Batch(const TPoint *points, std::size_t count, double *results, TKernel kernel) noexcept
+        {
+            SBlock Block;
+            for (std::size_t Offset = 0; Offset < count; Offset += BlockSize)
+            {
+                std::size_t Count = std::min(BlockSize, count - Offset);
+                Load(points + Offset, Count, Block);
+                kernel(Block, Count, results + Offset);
+            }
+        }
+
+        template <typename TPoint>
+        void HaversineBatch(const TLocation &origin, const TPoint *points, std::size_t count, double *results) noexcept
+        {
+            const double Latitude = origin.first * RadiansPerDegree;
+            const double Longitude = origin.second * RadiansPerDegree;
+            const double Cosine = std::cos(Latitude);
+            Batch(points, count, results, [&](SBlock &block, std::size_t blockcount, double *out) {
+                for (std::size_t Index = 0; Index < blockcount; Index++)
+                {
+                    double SinLat = std::sin((block.Latitudes[Index] - Latitude) * 0.5);
+                    double SinLon = std::sin((block.Longitudes[Index] - Longitude) * 0.5);
+                    block.First[Index] = SinLat * SinLat + Cosine * std::cos(block.Latitudes[Index]) * SinLon * SinLon;
+                }
+                Sqrt(block.First, blockcount, 1.0);
+                for (std::size_t Index = 0; Index < blockcount; Index++)
+                {
+                    out[Index] = 2.0 * EarthRadiusMeters * std::asin(block.First[Index]);
+                }
+            });
+        }
+
+        template <typename TPoint>
+        void EquirectangularBatch(const TLocation &origin, const TPoint *points, std::size_t count, double *results) noexcept
+        {
+            const double Latitude = origin.first * RadiansPerDegree;
+            const double Longitude = origin.second * RadiansPerDegree;
+            Batch(points, count, results, [&](SBlock &block, std::size_t blockcount, double *out) {
+                for (std::size_t Index = 0; Index < blockcount; Index++)
+                {
+                    block.Second[Index] = std::cos((block.Latitudes[Index] + Latitude) * 0.5);
+                }
+                for (std::size_t Index = 0; Index < blockcount; Index++)
+                {
+                    double X = (block.Longitudes[Index] - Longitude) * block.Second[Index];
+                    double Y = block.Latitudes[Index] - Latitude;
+                    block.First[Index] = X * X + Y * Y;
+                }
+                Sqrt(block.First, blockcount, std::numeric_limits<double>::infinity());
+                for (std::size_t Index = 0; Index < blockcount; Index++)
+                {
+                    out[Index] = EarthRadiusMeters * block.First[Index];
+                }
+            });
+        }
+
+        template <typename TPoint>
+        void BearingBatch(const TLocation &origin, const TPoint *points, std::size_t count, double *results) noexcept
+        {
+            const double Latitude = origin.first * RadiansPerDegree;
+            const double Longitude = origin.second * RadiansPerDegree;
+            const double Sine = std::sin(Latitude);
+            const double Cosine = std::cos(Latitude);
+            Batch(points, count, results, [&](SBlock &block, std::size_t blockcount, double *out) {
+                for (std::size_t Index = 0; Index < blockcount; Index++)
+                {
+                    double DeltaLon = block.Longitudes[Index] - Longitude;
+                    double CosLat = std::cos(block.Latitudes[Index]);
+                    double Y = std::sin(DeltaLon) * CosLat;
+                    double X = Cosine * std::sin(block.Latitudes[Index]) - Sine * CosLat * std::cos(DeltaLon);
+                    out[Index] = NormalizeBearing(std::atan2(Y, X));
+                }
+            });
+        }
+    }
+
+    SFixedLocation ToFixed(const TLocation &location) noexcept
+    {
+        SFixedLocation Result;
+        Result.DLatitude = int32_t(std::lround(location.first * FixedUnitsPerDegree));
+        Result.DLongitude = int32_t(std::lround(location.second * FixedUnitsPerDegree));
+        return Result;
+    }
+
+    TLocation FromFixed(const SFixedLocation &location) noexcept
+    {
+        return TLocation(location.DLatitude / FixedUnitsPerDegree, location.DLongitude / FixedUnitsPerDegree);
+    }
+
+    uint64_t HilbertIndex(const SFixedLocation &location) noexcept
+    {
+        // offset binary, so the curve runs from the most negative coordinate up
+        uint32_t X = uint32_t(location.DLongitude) ^ 0x80000000u;
+        uint32_t Y = uint32_t(location.DLatitude) ^ 0x80000000u;
+        uint64_t Result = 0;
+        for (uint32_t Side = 0x80000000u; Side; Side >>= 1)
+        {
+            uint32_t RX = (X & Side) ? 1 : 0;
+            uint32_t RY = (Y & Side) ? 1 : 0;
+            Result += uint64_t(Side) * Side * ((3 * RX) ^ RY);
+            // rotates the quadrant so the sub curve connects to its neighbours
+            if (!RY)
+            {
+                if (RX)
+                {
+                    X = ~X;
+                    Y = ~Y;
+                }
+                std::swap(X, Y);
+            }
+        }
+        return Result;
+    }
+
+    double HaversineDistance(const TLocation &src, const TLocation &dest) noexcept
+    {
+        double DeltaLat = (dest.first - src.first) * RadiansPerDegree;
+        double DeltaLon = (dest.second - src.second) * RadiansPerDegree;
+        double SinLat = std::sin(DeltaLat / 2.0);
+        double SinLon = std::sin(DeltaLon / 2.0);
+        double A = SinLat * SinLat + std::cos(src.first * RadiansPerDegree) * std::cos(dest.first * RadiansPerDegree) * SinLon * SinLon;
+        return 2.0 * EarthRadiusMeters * std::asin(std::min(1.0, std::sqrt(A)));
+    }
+
+    double EquirectangularDistance(const TLocation &src, const TLocation &dest) noexcept
+    {
+        double X = (dest.second - src.second) * RadiansPerDegree * std::cos((src.first + dest.first) * RadiansPerDegree / 2.0);
+        double Y = (dest.first - src.first) * RadiansPerDegree;
+        return EarthRadiusMeters * std::sqrt(X * X + Y * Y);
+    }
+
+    double Bearing(const TLocation &src, const TLocation &dest) noexcept
+    {
+        double SrcLat = src.first * RadiansPerDegree;
+        double DestLat = dest.first * RadiansPerDegree;
+        double DeltaLon = (dest.second - src.second) * RadiansPerDegree;
+        double Y = std::sin(DeltaLon) * std::cos(DestLat);
+        double X = std::cos(SrcLat) * std::sin(DestLat) - std::sin(SrcLat) * std::cos(DestLat) * std::cos(DeltaLon);
+        return NormalizeBearing(std::atan2(Y, X));
+    }
+
+    void HaversineDistances(const TLocation &origin, const TLocation *points, std::size_t count, double *results) noexcept
+    {
+        HaversineBatch(origin, points, count, results);
+    }
+
+    void HaversineDistances(const TLocation &origin, const SFixedLocation *points, std::size_t count, double *results) noexcept
+    {
+        HaversineBatch(origin, points, count, results);
+    }
+
+    void EquirectangularDistances(const TLocation &origin, const TLocation *points, std::size_t count, double *results) noexcept
+    {
+        EquirectangularBatch(origin, points, count, results);
+    }
+
+    void EquirectangularDistances(const TLocation &origin, const SFixedLocation *points, std::size_t count, double *results) noexcept
+    {
+        EquirectangularBatch(origin, points, count, results);
+    }
+
+    void Bearings(const TLocation &origin, const TLocation *points, std::size_t count, double *results) noexcept
+    {
+        BearingBatch(origin, points, count, results);
+    }
+
+    void Bearings(const TLocation &origin, const SFixedLocation *points, std::size_t count, double *results) noexcept
+    {
+        BearingBatch(origin, points, count, results);
+    }
+
+    void HaversineDistances(const SFixedLocation *locations, std::size_t locationcount, const uint32_t *sources, const uint32_t *targets, std::size_t count, double *results)
+    {
+        std::vector<double> Cosines(locationcount);
+        for (std::size_t Index = 0; Index < locationcount; Index++)
+        {
+            Cosines[Index] = std::cos(locations[Index].DLatitude * RadiansPerUnit);
+        }
+        SBlock Block;
+        for (std::size_t Offset = 0; Offset < count; Offset += BlockSize)
+        {
+            std::size_t Count = std::min(BlockSize, count - Offset);
+            for (std::size_t Index = 0; Index < Count; Index++)
+            {
+                uint32_t Source = sources[Offset + Index];
+                uint32_t Target = targets[Offset + Index];
+                // fixed point differences are exact, widened since longitudes can be 360 degrees apart
+                double SinLat = std::sin(double(int64_t(locations[Target].DLatitude) - locations[Source].DLatitude) * (RadiansPerUnit * 0.5));
+                double SinLon = std::sin(double(int64_t(locations[Target].DLongitude) - locations[Source].DLongitude) * (RadiansPerUnit * 0.5));
+                Block.First[Index] = SinLat * SinLat + Cosines[Source] * Cosines[Target] * SinLon * SinLon;
+            }
+            Sqrt(Block.First, Count, 1.0);
+            for (std::size_t Index = 0; Index < Count; Index++)
+            {
+                results[Offset + Index] = 2.0 * EarthRadiusMeters * std::asin(Block.First[Index]);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,128 @@
+#include "IDIndex.h"
+#include <algorithm>
+
+std::size_t CIDIndex::Slot(uint64_t id) const noexcept{
+    // fibonacci hashing, the high bits of the product spread the sequential ids osm extracts are full of
+    return (id * 0x9E3779B97F4A7C15ULL) >> DShift;
+}
+
+void CIDIndex::Build(const uint64_t *ids, std::size_t count){
+    std::size_t Capacity = 16;
+    DShift = 60;
+    while(Capacity < count * 2){
+        Capacity *= 2;
+        DShift--;
+    }
+    DMask = Capacity - 1;
+    DSlots.assign(Capacity, TEntry(0, NotFound));
+    for(std::size_t Index = 0; Index < count; Index++){
+        std::size_t Position = Slot(ids[Index]);
+        while(DSlots[Position].second != NotFound && DSlots[Position].first != ids[Index]){
+            Position = (Position + 1) & DMask;
+        }
+        // a repeated id keeps its first position, as the linear scans the index replaced did
+        if(DSlots[Position].second == NotFound){
+            DSlots[Position] = TEntry(ids[Index], Index);
+        }
+    }
+    DSorted.clear();
+    for(auto &Entry : DSlots){
+        if(Entry.second != NotFound){
+            DSorted.push_back(Entry);
+        }
+    }
+    std::sort(DSorted.begin(), DSorted.end());
+}
+
+std::size_t CIDIndex::Size() const noexcept{
+    return DSorted.size();
+}
+
+std::size_t CIDIndex::Find(uint64_t id) const noexcept{
+    if(DSlots.empty()){
+        return NotFound;
+    }
+    std::size_t Position = Slot(id);
+    while(DSlots[Position].second != NotFound){
+        if(DSlots[Position].first == id){
+            return DSlots[Position].second;
+        }
+        Position = (Position + 1) & DMask;
+    }
+    return NotFound;
+}
+
+void CIDIndex::Find(const uint64_t *ids, std::size_t count, std::size_t *positions) const{
+    // sorting a batch costs more than probing it, and a merge only streams faster than prefetched probes
+    // once the batch covers about half the column, so only such batches that arrive sorted are merged
+    if(count >= MergeThreshold && count * 2 >= DSorted.size() && std::is_sorted(ids, ids + count)){
+        FindMerged(ids, count, positions);
+    }
+    else{
+        FindProbed(ids, count, positions);
+    }
+}
+
+void CIDIndex::FindProbed(const uint64_t *ids, std::size_t count, std::size_t *positions) const noexcept{
+    if(DSlots.empty()){
+        std::fill(positions, positions + count, NotFound);
+        return;
+    }
+    // hash a group first and prefetch its slots, so the misses overlap instead of queueing one after another
+    constexpr std::size_t GroupSize = 16;
+    std::size_t Slots[GroupSize];
+    for(std::size_t Start = 0; Start < count; Start += GroupSize){
+        std::size_t End = std::min(count, Start + GroupSize);
+        for(std::size_t Index = Start; Index < End; Index++){
+            Slots[Index - Start] = Slot(ids[Index]);
+            __builtin_prefetch(&DSlots[Slots[Index - Start]]);
+        }
+        for(std::size_t Index = Start; Index < End; Index++){
+            std::size_t Position = Slots[Index - Start];
+            positions[Index] = NotFound;
+            while(DSlots[Position].second != NotFound){
+                if(DSlots[Position].first == ids[Index]){
+                    positions[Index] = DSlots[Position].second;
+                    break;
+                }
+                Position = (Position + 1) & DMask;
+            }
+        }
+    }
+}
+
+void CIDIndex::FindMerged(const uint64_t *ids, std::size_t count, std::size_t *positions) const{
+    if(!std::is_sorted(ids, ids + count)){
+        std::vector< TEntry > Queries(count);
+        for(std::size_t Index = 0; Index < count; Index++){
+            Queries[Index] = TEntry(ids[Index], Index);
+        }
+        std::sort(Queries.begin(), Queries.end());
+        std::vector< uint64_t > SortedIDs(count);
+        std::vector< std::size_t > SortedPositions(count);
+        for(std::size_t Index = 0; Index < count; Index++){
+            SortedIDs[Index] = Queries[Index].first;
+        }
+        FindMerged(SortedIDs.data(), count, SortedPositions.data());
+        for(std::size_t Index = 0; Index < count; Index++){
+            positions[Queries[Index].second] = SortedPositions[Index];
+        }
+        return;
+    }
+    // a batch much smaller than the column jumps ahead by binary search rather than walking every entry
+    bool Sparse = count * 8 < DSorted.size();
+    auto Column = DSorted.begin();
+    for(std::size_t Index = 0; Index < count; Index++){
+        if(Sparse){
+            Column = std::lower_bound(Column, DSorted.end(), ids[Index], [](const TEntry &entry, uint64_t id){
+                return entry.first < id;
+            });
+        }
+        else{
+            while(Column != DSorted.end() && Column->first < ids[Index]){
+                ++Column;
+            }
+        }
+        positions[Index] = Column != DSorted.end() && Column->first == ids[Index] ? Column->second : NotFound;
+    }
+}
@@ -0,0 +1,656 @@
+#include "LazyOpenStreetMap.h"
+#include "NumberUtils.h"
+#include <algorithm>
+#include <charconv>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using TAttributes = std::vector<std::pair<std::string, std::string>>;
+
+    // key value pairs in the order first seen, a later value for a key replaces the earlier one as in the eager map
+    struct SAttributeList {
+        TAttributes Attributes;
+
+        void Set(const std::string &key, const std::string &value) {
+            for (auto &Attribute : Attributes) {
+                if (Attribute.first == key) {
+                    Attribute.second = value;
+                    return;
+                }
+            }
+            Attributes.emplace_back(key, value);
+        }
+
+        const std::string *Find(const std::string &key) const noexcept {
+            for (auto &Attribute : Attributes) {
+                if (Attribute.first == key) {
+                    return &Attribute.second;
+                }
+            }
+            return nullptr;
+        }
+
+        std::string Key(std::size_t index) const noexcept {
+            return index < Attributes.size() ? Attributes[index].first : std::string();
+        }
+
+        std::string Value(const std::string &key) const noexcept {
+            auto Value = Find(key);
+            return Value ? *Value : std::string();
+        }
+    };
+
+    struct SNodeImpl : public CStreetMap::SNode {
+        CStreetMap::TNodeID NodeID = CStreetMap::InvalidNodeID;
+        CStreetMap::TLocation NLocation;
+        SAttributeList Attributes;
+
+        CStreetMap::TNodeID ID() const noexcept override {
+            return NodeID;
+        }
+
+        CStreetMap::TLocation Location() const noexcept override {
+            return NLocation;
+        }
+
+        std::size_t AttributeCount() const noexcept override {
+            return Attributes.Attributes.size();
+        }
+
+        std::string GetAttributeKey(std::size_t index) const noexcept override {
+            return Attributes.Key(index);
+        }
+
+        bool HasAttribute(const std::string &key) const noexcept override {
+            return Attributes.Find(key) != nullptr;
+        }
+
+        std::string GetAttribute(const std::string &key) const noexcept override {
+            return Attributes.Value(key);
+        }
+    };
+
+    struct SWayImpl : public CStreetMap::SWay {
+        CStreetMap::TWayID WayID = CStreetMap::InvalidWayID;
+        std::vector<CStreetMap::TNodeID> NodeIDs;
+        SAttributeList Attributes;
+
+        CStreetMap::TWayID ID() const noexcept override {
+            return WayID;
+        }
+
+        std::size_t NodeCount() const noexcept override {
+            return NodeIDs.size();
+        }
+
+        CStreetMap::TNodeID GetNodeID(std::size_t index) const noexcept override {
+            return index < NodeIDs.size() ? NodeIDs[index] : CStreetMap::InvalidNodeID;
+        }
+
+        std::size_t AttributeCount() const noexcept override {
+            return Attributes.Attributes.size();
+        }
+
+        std::string GetAttributeKey(std::size_t index) const noexcept override {
+            return Attributes.Key(index);
+        }
+
+        bool HasAttribute(const std::string &key) const noexcept override {
+            return Attributes.Find(key) != nullptr;
+        }
+
+        std::string GetAttribute(const std::string &key) const noexcept override {
+            return Attributes.Value(key);
+        }
+    };
+}
+
+struct CLazyOpenStreetMap::SImplementation {
+    // reads the source a block at a time from its current position, tracking the absolute offset
+    struct SScanner {
+        CSeekableDataSource *Source;
+        std::size_t BlockSize;
+        std::vector<char> Buffer;
+        std::size_t Index = 0;
+        std::size_t Base = 0;
+
+        SScanner(CSeekableDataSource *source, std::size_t blocksize) : Source(source), BlockSize(blocksize) {
+        }
+
+        // starts over from wherever the source was last seeked to, keeping the buffer's storage
+        void Reset() noexcept {
+            Buffer.clear();
+            Index = 0;
+            Base = 0;
+        }
+
+        bool Next(char &ch) {
+            if (Index == Buffer.size()) {
+                Base += Buffer.size();
+                Index = 0;
+                if (!Source->Read(Buffer, BlockSize)) {
+                    Buffer.clear();
+                    return false;
+                }
+            }
+            ch = Buffer[Index++];
+            return true;
+        }
+
+        // offset of the character most recently returned by Next
+        std::size_t Position() const {
+            return Base + Index - 1;
+        }
+    };
+
+    // one markup tag read straight from the source
+    struct STag {
+        std::string Name;
+        TAttributes Attributes;
+        bool Closing = false;
+        bool SelfClosing = false;
+
+        const std::string *Find(const std::string &key) const noexcept {
+            for (auto &Attribute : Attributes) {
+                if (Attribute.first == key) {
+                    return &Attribute.second;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    struct SNodeEntry {
+        TNodeID ID;
+        TLocation Location;
+        std::size_t Offset;
+    };
+
+    struct SWayEntry {
+        TWayID ID;
+        std::size_t Offset;
+    };
+
+    struct SCacheEntry {
+        std::size_t Key; // index * 2 for nodes, index * 2 + 1 for ways
+        std::shared_ptr<CStreetMap::SNode> Node;
+        std::shared_ptr<CStreetMap::SWay> Way;
+    };
+
+    std::shared_ptr<CSeekableDataSource> Source;
+    std::size_t CacheSize;
+    std::vector<SNodeEntry> Nodes;
+    std::vector<SWayEntry> Ways;
+    std::unordered_map<TNodeID, std::size_t> NodeIndices;
+    std::unordered_map<TWayID, std::size_t> WayIndices;
+
+    // most recently used first, Cached maps keys into the list
+    std::mutex CacheMutex;
+    std::list<SCacheEntry> Recent;
+    std::unordered_map<std::size_t, std::list<SCacheEntry>::iterator> Cached;
+    // elements handed out as handles outside of any scope, by cache key, never evicted
+    std::unordered_map<std::size_t, SCacheEntry> Pinned;
+
+    // elements handed out as handles while a CHandleScope is open, released with the scope
+    struct SScopePins {
+        const SImplementation *Map;
+        std::unordered_map<std::size_t, SCacheEntry> Pinned;
+    };
+    // open scopes of the current thread, innermost last
+    static thread_local std::vector<SScopePins *> Scopes;
+    // decoding state reused across misses, guarded by CacheMutex
+    SScanner Decoder;
+    STag Tag;
+
+    SImplementation(std::shared_ptr<CSeekableDataSource> src, std::size_t cachesize) : Source(src), CacheSize(cachesize), Decoder(src.get(), 4096) {
+        if (Source && Source->Seek(0)) {
+            Scan();
+        }
+        for (std::size_t Index = 0; Index < Nodes.size(); Index++) {
+            NodeIndices.emplace(Nodes[Index].ID, Index);
+        }
+        for (std::size_t Index = 0; Index < Ways.size(); Index++) {
+            WayIndices.emplace(Ways[Index].ID, Index);
+        }
+    }
+
+    // finds every node and way start tag, pulling out only the attributes the index needs
+    void Scan() {
+        SScanner Scanner(Source.get(), 1 << 16);
+        char Char;
+        std::string Name, Attribute, Value;
+        while (Scanner.Next(Char)) {
+            if (Char != '<') {
+                continue;
+            }
+            std::size_t Offset = Scanner.Position();
+            Name.clear();
+            while (Scanner.Next(Char) && Char != '>' && Char != '/' && Char != ' ' && Char != '\t' && Char != '\n' && Char != '\r') {
+                Name += Char;
+                if (Name == "!--") {
+                    break;
+                }
+            }
+            if (Name == "!--") {
+                // comments may hold anything, skip to the closing -->
+                int Dashes = 0;
+                while (Scanner.Next(Char) && !(Char == '>' && Dashes >= 2)) {
+                    Dashes = Char == '-' ? Dashes + 1 : 0;
+                }
+                continue;
+            }
+            bool IsNode = Name == "node";
+            bool IsWay = Name == "way";
+            TNodeID ID = InvalidNodeID;
+            TLocation Location;
+            bool Valid = true;
+            Attribute.clear();
+            // attributes up to the closing >, values are quoted so a > inside one does not end the tag
+            while (Char != '>') {
+                if (Char == '"' || Char == '\'') {
+                    char Quote = Char;
+                    Value.clear();
+                    while (Scanner.Next(Char) && Char != Quote) {
+                        Value += Char;
+                    }
+                    if (IsNode || IsWay) {
+                        // as in the eager map, an element whose id or location does not decode is dropped
+                        if (Attribute == "id") {
+                            Valid = NumberUtils::ToUInt64(Value, ID) && Valid;
+                        } else if (Attribute == "lat" && IsNode) {
+                            Valid = NumberUtils::ToDouble(Value, Location.first) && Valid;
+                        } else if (Attribute == "lon" && IsNode) {
+                            Valid = NumberUtils::ToDouble(Value, Location.second) && Valid;
+                        }
+                    }
+                    Attribute.clear();
+                } else if (Char != '=' && Char != ' ' && Char != '\t' && Char != '\n' && Char != '\r' && Char != '/') {
+                    Attribute += Char;
+                }
+                if (!Scanner.Next(Char)) {
+                    return;
+                }
+            }
+            if (!Valid) {
+                continue;
+            }
+            if (IsNode) {
+                Nodes.push_back(SNodeEntry{ID, Location, Offset});
+            } else if (IsWay) {
+                Ways.push_back(SWayEntry{ID, Offset});
+            }
+        }
+    }
+
+    static bool IsSpace(char ch) noexcept {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+    }
+
+    static void AppendUTF8(std::string &str, uint32_t code) {
+        if (code < 0x80) {
+            str += char(code);
+        } else if (code < 0x800) {
+            str += char(0xC0 | (code >> 6));
+            str += char(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            str += char(0xE0 | (code >> 12));
+            str += char(0x80 | ((code >> 6) & 0x3F));
+            str += char(0x80 | (code & 0x3F));
+        } else {
+            str += char(0xF0 | (code >> 18));
+            str += char(0x80 | ((code >> 12) & 0x3F));
+            str += char(0x80 | ((code >> 6) & 0x3F));
+            str += char(0x80 | (code & 0x3F));
+        }
+    }
+
+    // the text of an entity reference between & and ;, unknown references are kept as written
+    static void AppendEntity(std::string &str, const std::string &entity) {
+        if (entity == "lt") {
+            str += '<';
+        } else if (entity == "gt") {
+            str += '>';
+        } else if (entity == "amp") {
+            str += '&';
+        } else if (entity == "quot") {
+            str += '"';
+        } else if (entity == "apos") {
+            str += '\'';
+        } else if (entity.size() > 1 && entity[0] == '#') {
+            bool Hex = entity[1] == 'x';
+            uint32_t Code = 0;
+            auto First = entity.data() + (Hex ? 2 : 1);
+            auto Last = entity.data() + entity.size();
+            auto Result = std::from_chars(First, Last, Code, Hex ? 16 : 10);
+            if (Result.ec == std::errc() && Result.ptr == Last && First != Last && Code <= 0x10FFFF) {
+                AppendUTF8(str, Code);
+            } else {
+                str += "&" + entity + ";";
+            }
+        } else {
+            str += "&" + entity + ";";
+        }
+    }
+
+    // reads up to the next element tag, skipping comments, declarations and text, attribute values have their
+    // references decoded and whitespace normalized to spaces as an xml parser would, false at the end of the data
+    static bool ReadTag(SScanner &scanner, STag &tag) {
+        char Char;
+        tag.Name.clear();
+        tag.Attributes.clear();
+        tag.Closing = tag.SelfClosing = false;
+        while (true) {
+            do {
+                if (!scanner.Next(Char)) {
+                    return false;
+                }
+            } while (Char != '<');
+            if (!scanner.Next(Char)) {
+                return false;
+            }
+            if (Char != '!' && Char != '?') {
+                break;
+            }
+            // comments may hold anything up to the closing -->, the rest end at the first >
+            bool Comment = Char == '!' && scanner.Next(Char) && Char == '-' && scanner.Next(Char) && Char == '-';
+            int Dashes = 0;
+            while (Char != '>' || (Comment && Dashes < 2)) {
+                Dashes = Char == '-' ? Dashes + 1 : 0;
+                if (!scanner.Next(Char)) {
+                    return false;
+                }
+            }
+        }
+        if (Char == '/') {
+            tag.Closing = true;
+            if (!scanner.Next(Char)) {
+                return false;
+            }
+        }
+        while (!IsSpace(Char) && Char != '>' && Char != '/') {
+            tag.Name += Char;
+            if (!scanner.Next(Char)) {
+                return false;
+            }
+        }
+        while (Char != '>') {
+            if (Char == '/') {
+                tag.SelfClosing = true;
+            } else if (!IsSpace(Char)) {
+                std::string Key;
+                while (Char != '=' && !IsSpace(Char)) {
+                    Key += Char;
+                    if (!scanner.Next(Char)) {
+                        return false;
+                    }
+                }
+                while (Char != '"' && Char != '\'') {
+                    if (!scanner.Next(Char)) {
+                        return false;
+                    }
+                }
+                char Quote = Char;
+                std::string Value;
+                bool AfterCR = false;
+                while (scanner.Next(Char) && Char != Quote) {
+                    if (Char == '&') {
+                        std::string Entity;
+                        while (scanner.Next(Char) && Char != ';' && Char != Quote && Entity.size() < 16) {
+                            Entity += Char;
+                        }
+                        AppendEntity(Value, Entity);
+                        if (Char == Quote) {
+                            break;
+                        }
+                    } else if (Char == '\n' && AfterCR) {
+                        // a CR LF line end counts once
+                    } else {
+                        Value += IsSpace(Char) && Char != ' ' ? ' ' : Char;
+                    }
+                    AfterCR = Char == '\r';
+                }
+                if (Char != Quote) {
+                    return false;
+                }
+                tag.Attributes.emplace_back(std::move(Key), std::move(Value));
+            }
+            if (!scanner.Next(Char)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // reads the element starting at offset straight into its attributes, tags and refs, false if the source
+    // no longer holds that element there
+    bool Decode(std::size_t offset, const char *name, uint64_t &id, TLocation *location, std::vector<TNodeID> *refs, SAttributeList &attributes) {
+        if (!Source->Seek(offset)) {
+            return false;
+        }
+        Decoder.Reset();
+        if (!ReadTag(Decoder, Tag) || Tag.Closing || Tag.Name != name) {
+            return false;
+        }
+        // the same split as the eager loader, id and location are decoded and the other attributes kept
+        for (auto &Attribute : Tag.Attributes) {
+            if (Attribute.first == "id") {
+                NumberUtils::ToUInt64(Attribute.second, id);
+            } else if (location && Attribute.first == "lat") {
+                NumberUtils::ToDouble(Attribute.second, location->first);
+            } else if (location && Attribute.first == "lon") {
+                NumberUtils::ToDouble(Attribute.second, location->second);
+            } else {
+                attributes.Set(Attribute.first, Attribute.second);
+            }
+        }
+        std::size_t Depth = Tag.SelfClosing ? 0 : 1;
+        while (Depth && ReadTag(Decoder, Tag)) {
+            if (Tag.Closing) {
+                Depth--;
+                continue;
+            }
+            if (!Tag.SelfClosing) {
+                Depth++;
+            }
+            if (Tag.Name == "tag") {
+                auto Key = Tag.Find("k");
+                auto Value = Tag.Find("v");
+                if (Key && !Key->empty()) {
+                    attributes.Set(*Key, Value ? *Value : std::string());
+                }
+            } else if (refs && Tag.Name == "nd") {
+                auto Ref = Tag.Find("ref");
+                TNodeID NodeID;
+                if (Ref && NumberUtils::ToUInt64(*Ref, NodeID)) {
+                    refs->push_back(NodeID);
+                }
+            }
+        }
+        return true;
+    }
+
+    // the cached entry for key, decoding it on a miss, nullptr if it could not be decoded
+    const SCacheEntry *Lookup(std::size_t key) {
+        auto PinnedSearch = Pinned.find(key);
+        if (PinnedSearch != Pinned.end()) {
+            return &PinnedSearch->second;
+        }
+        auto Search = Cached.find(key);
+        if (Search != Cached.end()) {
+            Recent.splice(Recent.begin(), Recent, Search->second);
+            return &Recent.front();
+        }
+        SCacheEntry Entry{key, nullptr, nullptr};
+        if (key & 1) {
+            auto Way = std::make_shared<SWayImpl>();
+            if (!Decode(Ways[key / 2].Offset, "way", Way->WayID, nullptr, &Way->NodeIDs, Way->Attributes)) {
+                return nullptr;
+            }
+            Entry.Way = std::move(Way);
+        } else {
+            auto Node = std::make_shared<SNodeImpl>();
+            if (!Decode(Nodes[key / 2].Offset, "node", Node->NodeID, &Node->NLocation, nullptr, Node->Attributes)) {
+                return nullptr;
+            }
+            Entry.Node = std::move(Node);
+        }
+        Recent.push_front(std::move(Entry));
+        Cached[key] = Recent.begin();
+        while (Recent.size() > CacheSize && Recent.size() > 1) {
+            Cached.erase(Recent.back().Key);
+            Recent.pop_back();
+        }
+        return &Recent.front();
+    }
+
+    // the accessors are noexcept, a failed allocation or read comes back as no element
+    SScopePins *InnermostScope() const noexcept {
+        for (auto Scope = Scopes.rbegin(); Scope != Scopes.rend(); ++Scope) {
+            if ((*Scope)->Map == this) {
+                return *Scope;
+            }
+        }
+        return nullptr;
+    }
+
+    const SCacheEntry *Pin(std::size_t key, std::size_t count) noexcept {
+        if (key / 2 >= count) {
+            return nullptr;
+        }
+        try {
+            auto Scope = InnermostScope();
+            std::lock_guard<std::mutex> Lock(CacheMutex);
+            auto Search = Pinned.find(key);
+            if (Search != Pinned.end()) {
+                return &Search->second;
+            }
+            auto &Target = Scope ? Scope->Pinned : Pinned;
+            Search = Target.find(key);
+            if (Search == Target.end()) {
+                auto Entry = Lookup(key);
+                if (!Entry) {
+                    return nullptr;
+                }
+                Search = Target.emplace(key, *Entry).first;
+            }
+            return &Search->second;
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<CStreetMap::SNode> NodeByIndex(std::size_t index) noexcept {
+        if (index >= Nodes.size()) {
+            return nullptr;
+        }
+        try {
+            std::lock_guard<std::mutex> Lock(CacheMutex);
+            auto Entry = Lookup(index * 2);
+            return Entry ? Entry->Node : nullptr;
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<CStreetMap::SWay> WayByIndex(std::size_t index) noexcept {
+        if (index >= Ways.size()) {
+            return nullptr;
+        }
+        try {
+            std::lock_guard<std::mutex> Lock(CacheMutex);
+            auto Entry = Lookup(index * 2 + 1);
+            return Entry ? Entry->Way : nullptr;
+        } catch (...) {
+            return nullptr;
+        }
+    }
+};
+
+thread_local std::vector<CLazyOpenStreetMap::SImplementation::SScopePins *> CLazyOpenStreetMap::SImplementation::Scopes;
+
+struct CLazyOpenStreetMap::CHandleScope::SImplementation : CLazyOpenStreetMap::SImplementation::SScopePins {
+};
+
+CLazyOpenStreetMap::CHandleScope::CHandleScope(const CLazyOpenStreetMap &streetmap) : DImplementation(std::make_unique<SImplementation>()) {
+    DImplementation->Map = streetmap.DImplementation.get();
+    CLazyOpenStreetMap::SImplementation::Scopes.push_back(DImplementation.get());
+}
+
+CLazyOpenStreetMap::CHandleScope::~CHandleScope() {
+    auto &Scopes = CLazyOpenStreetMap::SImplementation::Scopes;
+    Scopes.erase(std::find(Scopes.begin(), Scopes.end(), DImplementation.get()));
+}
+
+std::size_t CLazyOpenStreetMap::CHandleScope::PinnedCount() const noexcept {
+    return DImplementation->Pinned.size();
+}
+
+CLazyOpenStreetMap::CLazyOpenStreetMap(std::shared_ptr<CSeekableDataSource> src, std::size_t cachesize) : DImplementation(std::make_unique<SImplementation>(src, cachesize)) {
+}
+
+CLazyOpenStreetMap::~CLazyOpenStreetMap() = default;
+
+std::size_t CLazyOpenStreetMap::NodeCount() const noexcept {
+    return DImplementation->Nodes.size();
+}
+
+std::size_t CLazyOpenStreetMap::WayCount() const noexcept {
+    return DImplementation->Ways.size();
+}
+
+std::shared_ptr<CStreetMap::SNode> CLazyOpenStreetMap::NodeByIndex(std::size_t index) const noexcept {
+    return DImplementation->NodeByIndex(index);
+}
+
+std::shared_ptr<CStreetMap::SNode> CLazyOpenStreetMap::NodeByID(TNodeID id) const noexcept {
+    auto Search = DImplementation->NodeIndices.find(id);
+    return Search == DImplementation->NodeIndices.end() ? nullptr : DImplementation->NodeByIndex(Search->second);
+}
+
+std::shared_ptr<CStreetMap::SWay> CLazyOpenStreetMap::WayByIndex(std::size_t index) const noexcept {
+    return DImplementation->WayByIndex(index);
+}
+
+std::shared_ptr<CStreetMap::SWay> CLazyOpenStreetMap::WayByID(TWayID id) const noexcept {
+    auto Search = DImplementation->WayIndices.find(id);
+    return Search == DImplementation->WayIndices.end() ? nullptr : DImplementation->WayByIndex(Search->second);
+}
+
+const CStreetMap::SNode *CLazyOpenStreetMap::NodeHandleByIndex(std::size_t index) const noexcept {
+    auto Entry = DImplementation->Pin(index * 2, DImplementation->Nodes.size());
+    return Entry ? Entry->Node.get() : nullptr;
+}
+
+const CStreetMap::SNode *CLazyOpenStreetMap::NodeHandleByID(TNodeID id) const noexcept {
+    auto Search = DImplementation->NodeIndices.find(id);
+    return Search == DImplementation->NodeIndices.end() ? nullptr : NodeHandleByIndex(Search->second);
+}
+
+const CStreetMap::SWay *CLazyOpenStreetMap::WayHandleByIndex(std::size_t index) const noexcept {
+    auto Entry = DImplementation->Pin(index * 2 + 1, DImplementation->Ways.size());
+    return Entry ? Entry->Way.get() : nullptr;
+}
+
+const CStreetMap::SWay *CLazyOpenStreetMap::WayHandleByID(TWayID id) const noexcept {
+    auto Search = DImplementation->WayIndices.find(id);
+    return Search == DImplementation->WayIndices.end() ? nullptr : WayHandleByIndex(Search->second);
+}
+
+CStreetMap::TLocation CLazyOpenStreetMap::NodeLocation(std::size_t index) const noexcept {
+    return index < DImplementation->Nodes.size() ? DImplementation->Nodes[index].Location : TLocation();
+}
+
+std::size_t CLazyOpenStreetMap::CachedCount() const noexcept {
+    std::lock_guard<std::mutex> Lock(DImplementation->CacheMutex);
+    return DImplementation->Recent.size();
+}
+
+std::size_t CLazyOpenStreetMap::PinnedCount() const noexcept {
+    std::lock_guard<std::mutex> Lock(DImplementation->CacheMutex);
+    return DImplementation->Pinned.size();
+}
+
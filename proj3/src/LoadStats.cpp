@@ -0,0 +1,48 @@
+#include "LoadStats.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace{
+    thread_local bool Counting = false;
+    thread_local std::size_t AllocationCount = 0;
+    thread_local std::size_t AllocatedBytes = 0;
+
+    std::size_t PeakResidentBytes() noexcept{
+#if defined(__APPLE__)
+        struct rusage Usage;
+        // macos reports bytes
+        return getrusage(RUSAGE_SELF, &Usage) == 0 ? std::size_t(Usage.ru_maxrss) : 0;
+#elif defined(__unix__)
+        struct rusage Usage;
+        // linux and the bsds report kilobytes
+        return getrusage(RUSAGE_SELF, &Usage) == 0 ? std::size_t(Usage.ru_maxrss) * 1024 : 0;
+#else
+        return 0;
+#endif
+    }
+}
+
+void CLoadStatsRecorder::CountAllocation(std::size_t size) noexcept{
+    if(Counting){
+        AllocationCount++;
+        AllocatedBytes += size;
+    }
+}
+
+CLoadStatsRecorder::CLoadStatsRecorder(SLoadStats *stats) noexcept : DStats(stats), DAllocationCount(0), DAllocatedBytes(0), DWasCounting(Counting){
+    if(DStats){
+        DAllocationCount = AllocationCount;
+        DAllocatedBytes = AllocatedBytes;
+        Counting = true;
+    }
+}
+
+CLoadStatsRecorder::~CLoadStatsRecorder(){
+    if(DStats){
+        Counting = DWasCounting;
+        DStats->DAllocationCount += AllocationCount - DAllocationCount;
+        DStats->DAllocatedBytes += AllocatedBytes - DAllocatedBytes;
+        DStats->DPeakResidentBytes = PeakResidentBytes();
+    }
+}
@@ -0,0 +1,141 @@
+#include "NameSearchIndex.h"
+#include "StringUtils.h"
+#include <algorithm>
+#include <unordered_map>
+
+struct CNameSearchIndex::SImplementation {
+    static constexpr std::size_t NoChild = std::numeric_limits<std::size_t>::max();
+
+    // bk-tree over the lowercased names, children of a node are a sibling list keyed by edit distance
+    struct STreeNode {
+        std::string DKey;
+        std::string DName;
+        std::vector<SEntry> DEntries;
+        int DEdge;
+        std::size_t DFirstChild = NoChild;
+        std::size_t DNextSibling = NoChild;
+    };
+
+    std::vector<STreeNode> Nodes;
+    std::unordered_map<std::string, std::size_t> NodesByKey;
+
+    void AddName(const std::string &name, EType type, uint64_t id) {
+        if (name.empty()) {
+            return;
+        }
+        std::string Key = StringUtils::Lower(name);
+        auto Search = NodesByKey.find(Key);
+        if (Search != NodesByKey.end()) {
+            Nodes[Search->second].DEntries.push_back(SEntry{type, id});
+            return;
+        }
+
+        std::size_t NewIndex = Nodes.size();
+        if (!Nodes.empty()) {
+            std::size_t Current = 0;
+            while (true) {
+                int Distance = StringUtils::EditDistance(Key, Nodes[Current].DKey);
+                std::size_t Child = Nodes[Current].DFirstChild;
+                while (Child != NoChild && Nodes[Child].DEdge != Distance) {
+                    Child = Nodes[Child].DNextSibling;
+                }
+                if (Child == NoChild) {
+                    STreeNode Node;
+                    Node.DEdge = Distance;
+                    Node.DNextSibling = Nodes[Current].DFirstChild;
+                    Nodes[Current].DFirstChild = NewIndex;
+                    Nodes.push_back(std::move(Node));
+                    break;
+                }
+                Current = Child;
+            }
+        } else {
+            Nodes.emplace_back();
+            Nodes.back().DEdge = 0;
+        }
+        Nodes[NewIndex].DKey = Key;
+        Nodes[NewIndex].DName = name;
+        Nodes[NewIndex].DEntries.push_back(SEntry{type, id});
+        NodesByKey[Key] = NewIndex;
+    }
+
+    std::vector<SMatch> Search(const std::string &query, std::size_t count, int maxdistance) const {
+        std::vector<std::pair<int, std::size_t>> Best; // (distance, node) kept sorted, at most count long
+        if (Nodes.empty() || count == 0 || maxdistance < 0) {
+            return {};
+        }
+        std::string Key = StringUtils::Lower(query);
+        int Radius = maxdistance;
+        std::vector<std::size_t> Pending{0};
+        while (!Pending.empty()) {
+            std::size_t Current = Pending.back();
+            Pending.pop_back();
+            int Distance = StringUtils::EditDistance(Key, Nodes[Current].DKey);
+            if (Distance <= Radius) {
+                auto Candidate = std::make_pair(Distance, Current);
+                auto Position = std::lower_bound(Best.begin(), Best.end(), Candidate, [this](const std::pair<int, std::size_t> &left, const std::pair<int, std::size_t> &right) {
+                    return left.first != right.first ? left.first < right.first : Nodes[left.second].DKey < Nodes[right.second].DKey;
+                });
+                Best.insert(Position, Candidate);
+                if (Best.size() > count) {
+                    Best.pop_back();
+                }
+                // once full only names at least as close as the current worst can still get in
+                if (Best.size() == count) {
+                    Radius = std::min(Radius, Best.back().first);
+                }
+            }
+            // triangle inequality, only subtrees with edge in [Distance - Radius, Distance + Radius] can hold matches
+            for (std::size_t Child = Nodes[Current].DFirstChild; Child != NoChild; Child = Nodes[Child].DNextSibling) {
+                if (Nodes[Child].DEdge >= Distance - Radius && Nodes[Child].DEdge <= Distance + Radius) {
+                    Pending.push_back(Child);
+                }
+            }
+        }
+
+        std::vector<SMatch> Matches;
+        for (auto &Entry : Best) {
+            Matches.push_back(SMatch{Nodes[Entry.second].DName, Entry.first, Nodes[Entry.second].DEntries});
+        }
+        return Matches;
+    }
+};
+
+CNameSearchIndex::CNameSearchIndex() : DImplementation(std::make_unique<SImplementation>()) {
+}
+
+CNameSearchIndex::CNameSearchIndex(std::shared_ptr<CStreetMap> streetmap, std::shared_ptr<CBusSystem> bussystem) : DImplementation(std::make_unique<SImplementation>()) {
+    if (streetmap) {
+        for (std::size_t Index = 0; Index < streetmap->NodeCount(); Index++) {
+            auto Node = streetmap->NodeByIndex(Index);
+            if (Node->HasAttribute("name")) {
+                DImplementation->AddName(Node->GetAttribute("name"), EType::Node, Node->ID());
+            }
+        }
+        for (std::size_t Index = 0; Index < streetmap->WayCount(); Index++) {
+            auto Way = streetmap->WayByIndex(Index);
+            if (Way->HasAttribute("name")) {
+                DImplementation->AddName(Way->GetAttribute("name"), EType::Way, Way->ID());
+            }
+        }
+    }
+    if (bussystem) {
+        for (std::size_t Index = 0; Index < bussystem->RouteCount(); Index++) {
+            DImplementation->AddName(bussystem->RouteHandleByIndex(Index)->Name(), EType::Route, Index);
+        }
+    }
+}
+
+CNameSearchIndex::~CNameSearchIndex() = default;
+
+void CNameSearchIndex::AddName(const std::string &name, EType type, uint64_t id) {
+    DImplementation->AddName(name, type, id);
+}
+
+std::size_t CNameSearchIndex::NameCount() const noexcept {
+    return DImplementation->Nodes.size();
+}
+
+std::vector<CNameSearchIndex::SMatch> CNameSearchIndex::Search(const std::string &query, std::size_t count, int maxdistance) const {
+    return DImplementation->Search(query, count, maxdistance);
+}
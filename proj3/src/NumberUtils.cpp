@@ -0,0 +1,64 @@
+#include "NumberUtils.h"
+#include "StringUtils.h"
+#include <charconv>
+
+namespace NumberUtils
+{
+
+    namespace
+    {
+        // from_chars does the work, this strips what stoull and stod used to accept and maps its error codes
+        template <typename T>
+        bool Decode(std::string_view str, T &value, SParseErrors *errors) noexcept
+        {
+            str = StringUtils::StripView(str);
+            if (str.size() > 1 && str.front() == '+' && str[1] != '-')
+            {
+                str.remove_prefix(1);
+            }
+            if (str.empty())
+            {
+                if (errors)
+                {
+                    errors->DEmpty++;
+                }
+                return false;
+            }
+            T Result;
+            auto [End, Error] = std::from_chars(str.data(), str.data() + str.size(), Result);
+            if (Error == std::errc() && End == str.data() + str.size())
+            {
+                value = Result;
+                return true;
+            }
+            if (errors)
+            {
+                if (Error == std::errc::result_out_of_range)
+                {
+                    errors->DOutOfRange++;
+                }
+                else
+                {
+                    errors->DInvalid++;
+                }
+            }
+            return false;
+        }
+    }
+
+    bool ToUInt64(std::string_view str, uint64_t &value, SParseErrors *errors) noexcept
+    {
+        return Decode(str, value, errors);
+    }
+
+    bool ToInt64(std::string_view str, int64_t &value, SParseErrors *errors) noexcept
+    {
+        return Decode(str, value, errors);
+    }
+
+    bool ToDouble(std::string_view str, double &value, SParseErrors *errors) noexcept
+    {
+        return Decode(str, value, errors);
+    }
+
+}
@@ -0,0 +1,225 @@
+#include "OSMFilter.h"
+#include "NumberUtils.h"
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+struct COSMFilter::SImplementation {
+    using TTag = std::pair<std::string, std::string>;
+
+    enum class EPass {Single, Scan, Closure};
+
+    bool HasBounds = false;
+    CStreetMap::TLocation LowerLeft;
+    CStreetMap::TLocation UpperRight;
+    std::vector<TTag> NodeTags;
+    std::vector<TTag> WayTags;
+    bool ReferencedOnly = false;
+    std::size_t KeptNodes = 0;
+    std::size_t KeptWays = 0;
+
+    // ids of nodes inside the box seen so far, ways come after nodes in osm files so this is complete when they arrive
+    std::unordered_set<CStreetMap::TNodeID> InsideNodes;
+    // nodes referenced by kept ways, found by the scan pass
+    std::unordered_set<CStreetMap::TNodeID> ReferencedNodes;
+
+    static bool TagsMatch(const std::vector<TTag> &filters, const std::vector<TTag> &tags) {
+        if (filters.empty()) {
+            return true;
+        }
+        for (auto &Filter : filters) {
+            for (auto &Tag : tags) {
+                if (Tag.first == Filter.first && (Filter.second == "*" || Tag.second == Filter.second)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static std::string Coordinate(double value) {
+        char Buffer[32];
+        std::snprintf(Buffer, sizeof(Buffer), "%.7f", value);
+        return Buffer;
+    }
+
+    // decides whether a top level element and its children are written, recording what later elements need
+    bool Keep(std::vector<SXMLEntity> &element, EPass pass) {
+        SXMLEntity &Start = element.front();
+        std::vector<TTag> Tags;
+        std::vector<CStreetMap::TNodeID> Refs;
+        for (auto &Entity : element) {
+            if (Entity.DType != SXMLEntity::EType::StartElement) {
+                continue;
+            }
+            if (Entity.DNameData == "tag") {
+                Tags.emplace_back(Entity.AttributeValue("k"), Entity.AttributeValue("v"));
+            } else if (Entity.DNameData == "nd") {
+                CStreetMap::TNodeID Ref;
+                if (NumberUtils::ToUInt64(Entity.AttributeValue("ref"), Ref)) {
+                    Refs.push_back(Ref);
+                }
+            }
+        }
+
+        if (Start.DNameData == "node") {
+            CStreetMap::TNodeID ID = CStreetMap::InvalidNodeID;
+            NumberUtils::ToUInt64(Start.AttributeValue("id"), ID);
+            bool Inside = true;
+            if (HasBounds) {
+                double Latitude = 0.0, Longitude = 0.0;
+                NumberUtils::ToDouble(Start.AttributeValue("lat"), Latitude);
+                NumberUtils::ToDouble(Start.AttributeValue("lon"), Longitude);
+                Inside = Latitude >= LowerLeft.first && Latitude <= UpperRight.first && Longitude >= LowerLeft.second && Longitude <= UpperRight.second;
+                if (Inside) {
+                    InsideNodes.insert(ID);
+                }
+            }
+            bool Matches = Inside && TagsMatch(NodeTags, Tags);
+            if (pass == EPass::Closure) {
+                return ReferencedNodes.count(ID) || (!ReferencedOnly && Matches);
+            }
+            return Matches;
+        }
+        if (Start.DNameData == "way") {
+            bool Matches = TagsMatch(WayTags, Tags);
+            if (Matches && HasBounds) {
+                Matches = false;
+                for (auto Ref : Refs) {
+                    if (InsideNodes.count(Ref)) {
+                        Matches = true;
+                        break;
+                    }
+                }
+            }
+            if (Matches && pass == EPass::Scan) {
+                ReferencedNodes.insert(Refs.begin(), Refs.end());
+            }
+            return Matches;
+        }
+        if (Start.DNameData == "bounds") {
+            if (HasBounds) {
+                Start.DAttributes = {{"minlat", Coordinate(LowerLeft.first)}, {"minlon", Coordinate(LowerLeft.second)},
+                                     {"maxlat", Coordinate(UpperRight.first)}, {"maxlon", Coordinate(UpperRight.second)}};
+            }
+            return true;
+        }
+        // relations would refer to members that may have been dropped
+        return Start.DNameData != "relation";
+    }
+
+    // empty elements come back from the reader as a start and end pair, write them as one complete element
+    static bool WriteElement(CXMLWriter &dest, std::vector<SXMLEntity> &element) {
+        for (std::size_t Index = 0; Index < element.size(); Index++) {
+            if (element[Index].DType == SXMLEntity::EType::StartElement && Index + 1 < element.size() && element[Index + 1].DType == SXMLEntity::EType::EndElement) {
+                element[Index].DType = SXMLEntity::EType::CompleteElement;
+                if (!dest.WriteEntity(element[Index])) {
+                    return false;
+                }
+                Index++;
+            } else if (!dest.WriteEntity(element[Index])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Run(CXMLReader &src, CXMLWriter *dest, EPass pass) {
+        InsideNodes.clear();
+        SXMLEntity Entity;
+        std::vector<SXMLEntity> Element; // the current top level element, preceded by the whitespace before it
+        int Depth = 0;
+        while (src.ReadEntity(Entity)) {
+            if (Depth >= 2) {
+                // inside a child of the root, collect until it closes
+                Element.push_back(Entity);
+                Depth += Entity.DType == SXMLEntity::EType::StartElement ? 1 : Entity.DType == SXMLEntity::EType::EndElement ? -1 : 0;
+                if (Depth > 1) {
+                    continue;
+                }
+                std::size_t Start = 0;
+                while (Element[Start].DType == SXMLEntity::EType::CharData) {
+                    Start++;
+                }
+                std::vector<SXMLEntity> Body(Element.begin() + Start, Element.end());
+                if (Keep(Body, pass)) {
+                    if (Body.front().DNameData == "node") {
+                        KeptNodes++;
+                    } else if (Body.front().DNameData == "way") {
+                        KeptWays++;
+                    }
+                    Element.resize(Start);
+                    Element.insert(Element.end(), Body.begin(), Body.end());
+                    if (dest && !WriteElement(*dest, Element)) {
+                        return false;
+                    }
+                }
+                Element.clear();
+            } else if (Entity.DType == SXMLEntity::EType::StartElement) {
+                if (Depth == 1) {
+                    Element.push_back(Entity);
+                } else if (dest && !dest->WriteEntity(Entity)) {
+                    return false;
+                }
+                Depth++;
+            } else if (Entity.DType == SXMLEntity::EType::EndElement) {
+                // the root closes, whitespace before it is kept
+                Depth--;
+                if (dest && (!WriteElement(*dest, Element) || !dest->WriteEntity(Entity))) {
+                    return false;
+                }
+                Element.clear();
+            } else if (Depth == 1) {
+                Element.push_back(Entity);
+            } else if (dest && !dest->WriteEntity(Entity)) {
+                return false;
+            }
+        }
+        // the reader stops early on malformed input without reaching its end
+        return src.End() && Depth == 0;
+    }
+};
+
+COSMFilter::COSMFilter() : DImplementation(std::make_unique<SImplementation>()) {
+}
+
+COSMFilter::~COSMFilter() = default;
+
+void COSMFilter::SetBoundingBox(CStreetMap::TLocation lowerleft, CStreetMap::TLocation upperright) {
+    DImplementation->HasBounds = true;
+    DImplementation->LowerLeft = lowerleft;
+    DImplementation->UpperRight = upperright;
+}
+
+void COSMFilter::AddTagFilter(EElement element, const std::string &key, const std::string &value) {
+    (element == EElement::Node ? DImplementation->NodeTags : DImplementation->WayTags).emplace_back(key, value);
+}
+
+void COSMFilter::SetReferencedNodesOnly(bool only) noexcept {
+    DImplementation->ReferencedOnly = only;
+}
+
+bool COSMFilter::Filter(std::shared_ptr<CXMLReader> src, std::shared_ptr<CXMLWriter> dest) {
+    DImplementation->KeptNodes = DImplementation->KeptWays = 0;
+    return src && dest && DImplementation->Run(*src, dest.get(), SImplementation::EPass::Single);
+}
+
+bool COSMFilter::Filter(std::shared_ptr<CXMLReader> scan, std::shared_ptr<CXMLReader> src, std::shared_ptr<CXMLWriter> dest) {
+    if (!scan || !src || !dest) {
+        return false;
+    }
+    DImplementation->ReferencedNodes.clear();
+    bool Success = DImplementation->Run(*scan, nullptr, SImplementation::EPass::Scan);
+    DImplementation->KeptNodes = DImplementation->KeptWays = 0;
+    Success = Success && DImplementation->Run(*src, dest.get(), SImplementation::EPass::Closure);
+    DImplementation->ReferencedNodes.clear();
+    return Success;
+}
+
+std::size_t COSMFilter::KeptNodeCount() const noexcept {
+    return DImplementation->KeptNodes;
+}
+
+std::size_t COSMFilter::KeptWayCount() const noexcept {
+    return DImplementation->KeptWays;
+}
@@ -1,15 +1,110 @@
 #include "OpenStreetMap.h"
 #include "XMLReader.h"
-#include <unordered_map> // to store nodes/ways by id
+#include "IDIndex.h"
+#include "GeographicUtils.h"
+#include "NumberUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <memory_resource> // elements and their strings live in a per map arena
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 #include <string>
 #include <memory> // to use smart pointers
 
+namespace {
+    using TArena = std::pmr::monotonic_buffer_resource;
+
+    // allocates from the arena and keeps it alive, so elements handed out remain valid after the map is gone
+    template <typename T>
+    struct SArenaAllocator {
+        using value_type = T;
+        std::shared_ptr<TArena> Arena;
+
+        SArenaAllocator(std::shared_ptr<TArena> arena) : Arena(std::move(arena)) {
+        }
+
+        template <typename U>
+        SArenaAllocator(const SArenaAllocator<U> &other) : Arena(other.Arena) {
+        }
+
+        T *allocate(std::size_t count) {
+            return static_cast<T *>(Arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *, std::size_t) noexcept { // released all at once with the arena
+        }
+
+        template <typename U>
+        bool operator==(const SArenaAllocator<U> &other) const noexcept {
+            return Arena == other.Arena;
+        }
+
+        template <typename U>
+        bool operator!=(const SArenaAllocator<U> &other) const noexcept {
+            return Arena != other.Arena;
+        }
+    };
+
+    // key value pairs in the order first seen, elements have few so a linear search beats hashing
+    struct SAttributeList {
+        std::pmr::vector<std::pair<std::string_view, std::string_view>> attributes;
+
+        SAttributeList(TArena *arena) : attributes(arena) {
+        }
+
+        static std::string_view Copy(TArena *arena, const std::string &str) {
+            if (str.empty()) {
+                return std::string_view();
+            }
+            char *data = static_cast<char *>(arena->allocate(str.size(), 1));
+            std::memcpy(data, str.data(), str.size());
+            return std::string_view(data, str.size());
+        }
+
+        // a later value for the same key replaces the earlier one
+        void Set(TArena *arena, const std::string &key, const std::string &value) {
+            for (auto &attribute : attributes) {
+                if (attribute.first == key) {
+                    attribute.second = Copy(arena, value);
+                    return;
+                }
+            }
+            attributes.emplace_back(Copy(arena, key), Copy(arena, value));
+        }
+
+        const std::pair<std::string_view, std::string_view> *Find(const std::string &key) const noexcept {
+            for (auto &attribute : attributes) {
+                if (attribute.first == key) {
+                    return &attribute;
+                }
+            }
+            return nullptr;
+        }
+
+        std::string Key(std::size_t i) const noexcept {
+            if (i >= attributes.size()) {
+                return ""; // return "" if index goes out of bounds
+            }
+            return std::string(attributes[i].first); // return key at given index
+        }
+
+        std::string Value(const std::string &key) const noexcept {
+            auto attribute = Find(key);
+            return attribute ? std::string(attribute->second) : std::string(); // return "" if key not found
+        }
+    };
+}
+
 struct COpenStreetMap::SImplementation {
     struct SNodeImpl : public CStreetMap::SNode { // implementation of SNode
         TNodeID NodeID; // initiate its variables
         TLocation NLocation;
-        std::unordered_map<std::string, std::string> attributes;
+        SAttributeList attributes;
+
+        SNodeImpl(TArena *arena) : attributes(arena) {
+        }
 
         TNodeID ID() const noexcept override {
             return NodeID;
@@ -20,44 +115,32 @@ struct COpenStreetMap::SImplementation {
         }
 
         std::size_t AttributeCount() const noexcept override {
-            return attributes.size();
+            return attributes.attributes.size();
         }
 
         std::string GetAttributeKey(std::size_t i) const noexcept override {
-            if (i >= attributes.size()) {
-                return ""; // return "" if index goes out of bounds
-            }
-            auto iterate = attributes.begin();
-            for (std::size_t j = 0; j < i; j++) {
-                iterate++;
-            }
-            return iterate->first; // return key at given index
+            return attributes.Key(i);
         }
 
         bool HasAttribute(const std::string & key) const noexcept override {
-            if (attributes.find(key) != attributes.end()) {
-                return true;
-            } else {
-                return false;
-            }
+            return attributes.Find(key) != nullptr;
         }
 
         std::string GetAttribute(const std::string & key) const noexcept override {
-            auto iterate = attributes.find(key);
-            if (iterate == attributes.end()) {
-                return ""; // return "" if key out of bounds
-            } else {
-                return iterate->second; // return the attribute 
-            }
+            return attributes.Value(key);
         }
     };
 
+    std::shared_ptr<TArena> arena = std::make_shared<TArena>();
     std::vector<std::shared_ptr<SNodeImpl>> nodes; // initialize vector to store nodes
     
     struct SWayImpl : public CStreetMap::SWay { // implementation of SWay
         TWayID wayID; 
-        std::vector<TNodeID> nodeids;
-        std::unordered_map<std::string, std::string> attributes;
+        std::pmr::vector<TNodeID> nodeids;
+        SAttributeList attributes;
+
+        SWayImpl(TArena *arena) : nodeids(arena), attributes(arena) {
+        }
 
         TWayID ID() const noexcept override {
             return wayID;
@@ -67,114 +150,289 @@ struct COpenStreetMap::SImplementation {
             return nodeids.size();
         }
 
-        std::string GetAttributeKey(std::size_t i) const noexcept override {
-            if (i >= attributes.size()) {
-                return "";
-            }
-            auto iterate = attributes.begin();
-            for (std::size_t j = 0; j < i; j++) {
-                iterate++;
+        TNodeID GetNodeID(std::size_t i) const noexcept override {
+            if (i >= nodeids.size()) {
+                return InvalidNodeID; // return invalid id if index goes out of bounds
             }
-            return iterate->first;
+            return nodeids[i];
+        }
+
+        std::size_t AttributeCount() const noexcept override {
+            return attributes.attributes.size();
+        }
+
+        std::string GetAttributeKey(std::size_t i) const noexcept override {
+            return attributes.Key(i);
         }
 
         bool HasAttribute(const std::string & key) const noexcept override {
-            if (attributes.find(key) != attributes.end()) {
-                return true;
-            } else {
-                return false;
-            }
+            return attributes.Find(key) != nullptr;
         }
 
         std::string GetAttribute(const std::string & key) const noexcept override {
-            auto iterate = attributes.find(key);
-            if (iterate == attributes.end()) {
-                return "";
-            } else {
-                return iterate->second;
-            }
+            return attributes.Value(key);
         }
     };
 
     std::vector<std::shared_ptr<SWayImpl>> ways; // initialize vector to store ways
+    std::size_t tagcount = 0; // tag elements seen, only reported through load stats
+    SParseErrors parseErrors;
+
+    using TTag = SLoadOptions::TTag;
 
-    void parse(std::shared_ptr<CXMLReader> src) { // parses the OpenStreetMap file
+    CIDIndex nodeIndex; // built once parsing is done, elements are never added afterwards
+    CIDIndex wayIndex;
+
+    void buildIndices(bool spatialorder) {
+        std::vector<uint64_t> ids(nodes.size());
+        for (std::size_t index = 0; index < nodes.size(); index++) {
+            ids[index] = nodes[index]->NodeID;
+        }
+        nodeIndex.Build(ids.data(), ids.size());
+        if (spatialorder) {
+            orderWays();
+        }
+        ids.resize(ways.size());
+        for (std::size_t index = 0; index < ways.size(); index++) {
+            ids[index] = ways[index]->wayID;
+        }
+        wayIndex.Build(ids.data(), ids.size());
+    }
+
+    // sorts ways by the hilbert key of the mean location of their nodes, ways with none on the map go last
+    void orderWays() {
+        std::vector<uint64_t> keys(ways.size(), UINT64_MAX);
+        std::vector<std::size_t> positions;
+        for (std::size_t index = 0; index < ways.size(); index++) {
+            auto &refs = ways[index]->nodeids;
+            positions.resize(refs.size());
+            nodeIndex.Find(refs.data(), refs.size(), positions.data());
+            int64_t latitudes = 0, longitudes = 0, found = 0;
+            for (auto position : positions) {
+                if (position != CIDIndex::NotFound) {
+                    SFixedLocation location = GeographicUtils::ToFixed(nodes[position]->NLocation);
+                    latitudes += location.DLatitude;
+                    longitudes += location.DLongitude;
+                    found++;
+                }
+            }
+            if (found) {
+                keys[index] = GeographicUtils::HilbertIndex(SFixedLocation{int32_t(latitudes / found), int32_t(longitudes / found)});
+            }
+        }
+        std::vector<std::size_t> order(ways.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t first, std::size_t second) {
+            return keys[first] < keys[second];
+        });
+        std::vector<std::shared_ptr<SWayImpl>> ordered;
+        ordered.reserve(ways.size());
+        for (auto index : order) {
+            ordered.push_back(std::move(ways[index]));
+        }
+        ways.swap(ordered);
+    }
+
+    // index of the node or way with the id, or the element count if there is none
+    std::size_t FindNode(TNodeID id) const noexcept {
+        std::size_t index = nodeIndex.Find(id);
+        return index == CIDIndex::NotFound ? nodes.size() : index;
+    }
+
+    std::size_t FindWay(TWayID id) const noexcept {
+        std::size_t index = wayIndex.Find(id);
+        return index == CIDIndex::NotFound ? ways.size() : index;
+    }
+
+    // a node kept in compact form until the ways that reference it or its place on the curve are known,
+    // its tags are pendingTags[TagBegin .. TagEnd)
+    struct SPendingNode {
+        TNodeID NodeID;
+        TLocation NLocation;
+        std::size_t TagBegin;
+        std::size_t TagEnd;
+    };
+
+    void parse(std::shared_ptr<CXMLReader> src, const SLoadOptions &options) { // parses the OpenStreetMap file
         SXMLEntity ent;
-        std::shared_ptr<SNodeImpl> currNode = nullptr; // shared pointers to track current node/way
-        std::shared_ptr<SWayImpl> currWay = nullptr;
+        std::unordered_set<std::string> keys(options.DTagKeys.begin(), options.DTagKeys.end());
+        auto keepKey = [&](const std::string &key) {
+            return keys.empty() || keys.count(key);
+        };
+        // elements are gathered into these and only built once they are known to be kept
+        enum class ECurrent {None, Node, Way} current = ECurrent::None;
+        uint64_t id = 0;
+        TLocation location;
+        std::vector<TTag> extra; // xml attributes other than id, lat and lon
+        std::vector<TTag> tags;
+        std::vector<TNodeID> refs;
+
+        std::unordered_set<TNodeID> inside; // nodes inside the bounding box, ways come after nodes so it is complete for them
+        std::unordered_set<TNodeID> referenced;
+        std::vector<SPendingNode> pending;
+        std::vector<TTag> pendingTags;
+
+        auto fill = [&](auto &attributes, auto first, auto last) {
+            for (; first != last; ++first) {
+                if (keepKey(first->first)) {
+                    attributes.Set(arena.get(), first->first, first->second);
+                }
+            }
+        };
+        auto insideBounds = [&](TLocation nodelocation) {
+            return nodelocation.first >= options.DLowerLeft.first && nodelocation.first <= options.DUpperRight.first
+                && nodelocation.second >= options.DLowerLeft.second && nodelocation.second <= options.DUpperRight.second;
+        };
+        auto addNode = [&](TNodeID nodeid, TLocation nodelocation, auto first, auto last) {
+            auto node = std::allocate_shared<SNodeImpl>(SArenaAllocator<SNodeImpl>(arena), arena.get());
+            node->NodeID = nodeid;
+            node->NLocation = nodelocation;
+            fill(node->attributes, first, last);
+            nodes.push_back(node); // add the node to the vector
+        };
 
         while (src->ReadEntity(ent)) {
             if (ent.DType == SXMLEntity::EType::StartElement) {
-                if (ent.DNameData == "node") { // to process a node
-                    currNode = std::make_shared<SNodeImpl>(); // create a new node
-    
+                if (ent.DNameData == "node" || ent.DNameData == "way") { // to process a node or way
+                    current = ent.DNameData == "node" ? ECurrent::Node : ECurrent::Way;
+                    location = TLocation();
+                    extra.clear();
+                    tags.clear();
+                    refs.clear();
+                    // an element whose id or location does not decode is dropped along with its children
                     for (const auto & attribute : ent.DAttributes) {
                         if (attribute.first == "id") {
-                            currNode->NodeID = std::stoull(attribute.second); // stoull converts string to unsigned long long
-                        } else if (attribute.first == "lat") { // latitude converted to double and stored
-                            currNode->NLocation.first = std::stod(attribute.second);
-                        } else if (attribute.first == "lon") { // longitude also converted
-                            currNode->NLocation.second = std::stod(attribute.second);
+                            if (!NumberUtils::ToUInt64(attribute.second, id, &parseErrors)) {
+                                current = ECurrent::None;
+                            }
+                        } else if (attribute.first == "lat" && current == ECurrent::Node) { // latitude converted to double and stored
+                            if (!NumberUtils::ToDouble(attribute.second, location.first, &parseErrors)) {
+                                current = ECurrent::None;
+                            }
+                        } else if (attribute.first == "lon" && current == ECurrent::Node) { // longitude also converted
+                            if (!NumberUtils::ToDouble(attribute.second, location.second, &parseErrors)) {
+                                current = ECurrent::None;
+                            }
                         } else { // other attributes
-                            currNode->attributes[attribute.first] = attribute.second;
+                            extra.push_back(attribute);
                         }
                     }
-    
-                } else if (ent.DNameData == "way") { // to process a way
-                    currWay = std::make_shared<SWayImpl>(); // create a new way
-    
-                    for (const auto & attribute : ent.DAttributes) {
-                        if (attribute.first == "id") {
-                            currWay->wayID = std::stoull(attribute.second); // store the way ID
-                        } else {
-                            currWay->attributes[attribute.first] = attribute.second;
-                        }
+                    // elements that cannot be kept are skipped whole, without building their children
+                    bool outside = current == ECurrent::Node && options.DUseBounds && !options.DReferencedNodesOnly && !insideBounds(location);
+                    if (current == ECurrent::None || outside) {
+                        current = ECurrent::None;
+                        src->SkipElement();
                     }
-    
-                } else if (ent.DNameData == "nd" && currWay) { // process node reference in way
+                } else if (ent.DNameData == "relation" && current == ECurrent::None) { // relations are not part of the street map
+                    src->SkipElement();
+                } else if (ent.DNameData == "nd" && current == ECurrent::Way) { // process node reference in way
                     for (const auto & attribute : ent.DAttributes) {
-                        if (attribute.first == "ref") {
-                            currWay->nodeids.push_back(std::stoull(attribute.second)); // add node ID to the way's node list
+                        TNodeID ref;
+                        if (attribute.first == "ref" && NumberUtils::ToUInt64(attribute.second, ref, &parseErrors)) {
+                            refs.push_back(ref); // add node ID to the way's node list
                         }
                     }
-                } else if (ent.DNameData == "tag") { // processing tag element for both node/way
-                    std::string k; // initialize key and value 
-                    std::string v;
-    
-                    for (const auto & attribute : ent.DAttributes) {
-                        if (attribute.first == "k") {
-                            k = attribute.second; // store key
-                        }
-                        if (attribute.first == "v") {
-                            v = attribute.second; // store value
+                } else if (ent.DNameData == "tag" && current != ECurrent::None) { // processing tag element for both node/way
+                    std::string k = ent.AttributeValue("k");
+                    if (!k.empty()) {
+                        tagcount++;
+                        tags.emplace_back(std::move(k), ent.AttributeValue("v"));
+                    }
+                }
+            } else if (ent.DType == SXMLEntity::EType::EndElement) {
+                if (ent.DNameData == "node" && current == ECurrent::Node) {
+                    current = ECurrent::None;
+                    bool isInside = !options.DUseBounds || insideBounds(location);
+                    if (isInside && options.DUseBounds) {
+                        inside.insert(id);
+                    }
+                    if (options.DReferencedNodesOnly || (options.DSpatialOrder && isInside)) {
+                        // only the whitelisted tags are held until the end of the file
+                        std::size_t tagBegin = pendingTags.size();
+                        for (auto *list : {&extra, &tags}) {
+                            for (auto &tag : *list) {
+                                if (keepKey(tag.first)) {
+                                    pendingTags.push_back(std::move(tag));
+                                }
+                            }
                         }
+                        pending.push_back(SPendingNode{id, location, tagBegin, pendingTags.size()});
+                    } else if (isInside) {
+                        extra.insert(extra.end(), tags.begin(), tags.end()); // tags override attributes of the same name
+                        addNode(id, location, extra.begin(), extra.end());
                     }
-    
-                    if (!k.empty()) {
-                        if (currWay) {
-                            currWay->attributes[k] = v; // Add the key, value pair to the way
+                } else if (ent.DNameData == "way" && current == ECurrent::Way) {
+                    current = ECurrent::None;
+                    bool keep = !options.DWayFilter || options.DWayFilter(tags);
+                    if (keep && options.DUseBounds) {
+                        keep = false;
+                        for (auto ref : refs) {
+                            if (inside.count(ref)) {
+                                keep = true;
+                                break;
+                            }
                         }
-                        if (currNode) {
-                            currNode->attributes[k] = v; // Add the key, value pair to the node
+                    }
+                    if (keep) {
+                        auto way = std::allocate_shared<SWayImpl>(SArenaAllocator<SWayImpl>(arena), arena.get());
+                        way->wayID = id;
+                        way->nodeids.assign(refs.begin(), refs.end());
+                        fill(way->attributes, extra.begin(), extra.end());
+                        fill(way->attributes, tags.begin(), tags.end());
+                        ways.push_back(way); // add the way to the vector
+                        if (options.DReferencedNodesOnly) {
+                            referenced.insert(refs.begin(), refs.end());
                         }
                     }
                 }
-            } else if (ent.DType == SXMLEntity::EType::EndElement) {
-                if (ent.DNameData == "node" && currNode) {
-                    nodes.push_back(currNode); // add the node to the vector and map
-                    currNode = nullptr;
-                } else if (ent.DNameData == "way" && currWay) {
-                    ways.push_back(currWay); // add the way to the vector and map
-                    currWay = nullptr;
-                }
+            }
+        }
+
+        // held nodes are built last, in curve order when asked so neighbours on the ground share the arena
+        std::vector<std::size_t> order(pending.size());
+        std::iota(order.begin(), order.end(), 0);
+        if (options.DSpatialOrder) {
+            std::vector<uint64_t> keys(pending.size());
+            for (std::size_t index = 0; index < pending.size(); index++) {
+                keys[index] = GeographicUtils::HilbertIndex(GeographicUtils::ToFixed(pending[index].NLocation));
+            }
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t first, std::size_t second) {
+                return keys[first] < keys[second];
+            });
+        }
+        for (auto index : order) {
+            auto &node = pending[index];
+            if (!options.DReferencedNodesOnly || referenced.count(node.NodeID)) {
+                addNode(node.NodeID, node.NLocation, pendingTags.begin() + node.TagBegin, pendingTags.begin() + node.TagEnd);
             }
         }
     }
 };
 
 // constructor
-COpenStreetMap::COpenStreetMap(std::shared_ptr<CXMLReader> src) : DImplementation(std::make_unique<SImplementation>()){
-    DImplementation->parse(src);
+COpenStreetMap::COpenStreetMap(std::shared_ptr<CXMLReader> src, SLoadStats *stats) : COpenStreetMap(src, SLoadOptions(), stats){
+}
+
+COpenStreetMap::COpenStreetMap(std::shared_ptr<CXMLReader> src, const SLoadOptions &options, SLoadStats *stats) : DImplementation(std::make_unique<SImplementation>()){
+    CLoadStatsRecorder Recorder(stats);
+    double Total = 0.0; // reader phases are subtracted from the whole parse to leave the entity build time
+    double ReaderBefore = stats ? stats->DIOSeconds + stats->DTokenizeSeconds : 0.0;
+    src->SetStats(stats);
+    {
+        CLoadPhaseTimer Timer(stats ? &Total : nullptr);
+        DImplementation->parse(src, options);
+    }
+    src->SetStats(nullptr);
+    {
+        CLoadPhaseTimer IndexTimer(stats ? &stats->DIndexSeconds : nullptr);
+        DImplementation->buildIndices(options.DSpatialOrder);
+    }
+    if (stats) {
+        stats->DBuildSeconds += Total - (stats->DIOSeconds + stats->DTokenizeSeconds - ReaderBefore);
+        stats->DNodeCount += DImplementation->nodes.size();
+        stats->DWayCount += DImplementation->ways.size();
+        stats->DTagCount += DImplementation->tagcount;
+    }
 }
 
 // destructor
@@ -200,12 +458,7 @@ std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByIndex(std::size_t index
 
 // get node by ID
 std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByID(TNodeID id) const noexcept {
-    for (auto & n : DImplementation->nodes) {
-        if (n->ID() == id) {
-            return n;
-        }
-    }
-    return nullptr; // return nullptr if node not found
+    return NodeByIndex(DImplementation->FindNode(id)); // out of bound when not found
 }
 
 // get way by index
@@ -218,10 +471,65 @@ std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByIndex(std::size_t index)
 
 // get way by ID
 std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByID(TWayID id) const noexcept {
-    for (auto & w : DImplementation->ways) {
-        if (w->ID() == id) {
-            return w;
-        }
+    return WayByIndex(DImplementation->FindWay(id));
+}
+
+// handles point at the elements the map holds, so they need no reference counting
+const CStreetMap::SNode *COpenStreetMap::NodeHandleByIndex(std::size_t index) const noexcept {
+    return index < DImplementation->nodes.size() ? DImplementation->nodes[index].get() : nullptr;
+}
+
+const CStreetMap::SNode *COpenStreetMap::NodeHandleByID(TNodeID id) const noexcept {
+    return NodeHandleByIndex(DImplementation->FindNode(id));
+}
+
+const CStreetMap::SWay *COpenStreetMap::WayHandleByIndex(std::size_t index) const noexcept {
+    return index < DImplementation->ways.size() ? DImplementation->ways[index].get() : nullptr;
+}
+
+const CStreetMap::SWay *COpenStreetMap::WayHandleByID(TWayID id) const noexcept {
+    return WayHandleByIndex(DImplementation->FindWay(id));
+}
+
+void COpenStreetMap::NodeIndicesByID(const TNodeID *ids, std::size_t count, std::size_t *indices) const {
+    DImplementation->nodeIndex.Find(ids, count, indices);
+    std::replace(indices, indices + count, CIDIndex::NotFound, DImplementation->nodes.size());
+}
+
+void COpenStreetMap::NodeHandlesByID(const TNodeID *ids, std::size_t count, const CStreetMap::SNode **nodes) const {
+    std::vector<std::size_t> indices(count);
+    NodeIndicesByID(ids, count, indices.data());
+    for (std::size_t index = 0; index < count; index++) {
+        nodes[index] = NodeHandleByIndex(indices[index]);
     }
-    return nullptr; // return nullptr if way not found
+}
+
+void COpenStreetMap::WayIndicesByID(const TWayID *ids, std::size_t count, std::size_t *indices) const {
+    DImplementation->wayIndex.Find(ids, count, indices);
+    std::replace(indices, indices + count, CIDIndex::NotFound, DImplementation->ways.size());
+}
+
+void COpenStreetMap::WayHandlesByID(const TWayID *ids, std::size_t count, const CStreetMap::SWay **ways) const {
+    std::vector<std::size_t> indices(count);
+    WayIndicesByID(ids, count, indices.data());
+    for (std::size_t index = 0; index < count; index++) {
+        ways[index] = WayHandleByIndex(indices[index]);
+    }
+}
+
+void COpenStreetMap::ResolveWayNodes(std::vector<std::size_t> &offsets, std::vector<std::size_t> &indices) const {
+    // every ref of every way goes through one batch so the hash probes are prefetched in groups, refs come in
+    // way order rather than id order, so the index probes them instead of merging
+    std::vector<TNodeID> refs;
+    offsets.assign(1, 0);
+    for (auto &way : DImplementation->ways) {
+        refs.insert(refs.end(), way->nodeids.begin(), way->nodeids.end());
+        offsets.push_back(refs.size());
+    }
+    indices.resize(refs.size());
+    NodeIndicesByID(refs.data(), refs.size(), indices.data());
+}
+
+const SParseErrors &COpenStreetMap::ParseErrors() const noexcept {
+    return DImplementation->parseErrors;
 }
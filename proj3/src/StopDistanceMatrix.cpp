@@ -0,0 +1,281 @@
+#include "StopDistanceMatrix.h"
+#include "GeographicUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct CStopDistanceMatrix::SImplementation {
+    using TNodeIndex = uint32_t;
+    static constexpr TNodeIndex InvalidNodeIndex = std::numeric_limits<TNodeIndex>::max();
+
+    // street graph in CSR layout, edges of node i are EdgeTargets[EdgeOffsets[i] .. EdgeOffsets[i + 1])
+    std::vector<std::size_t> EdgeOffsets;
+    std::vector<TNodeIndex> EdgeTargets;
+    std::vector<double> EdgeWeights;
+
+    std::vector<CBusSystem::TStopID> StopIDs;
+    std::vector<TNodeIndex> StopNodes; // graph node of each stop, InvalidNodeIndex if not on the map
+    std::unordered_map<CBusSystem::TStopID, std::size_t> StopIndices;
+    std::vector<uint8_t> TargetNodes; // 1 if some stop sits on the node
+    std::size_t TargetNodeCount = 0;
+
+    std::vector<double> Distances; // row major StopCount x StopCount
+    bool Computed = false;
+
+    // per thread search state, reset lazily through the touched list
+    struct SSearchState {
+        std::vector<double> NodeDistances;
+        std::vector<uint8_t> Settled;
+        std::vector<TNodeIndex> Touched;
+    };
+
+    SImplementation(const CStreetMap &streetmap, const CBusSystem &bussystem) {
+        std::unordered_map<CStreetMap::TNodeID, TNodeIndex> NodeIndices;
+        std::vector<SFixedLocation> Locations(streetmap.NodeCount());
+        NodeIndices.reserve(streetmap.NodeCount());
+        for (std::size_t Index = 0; Index < streetmap.NodeCount(); Index++) {
+            auto Node = streetmap.NodeByIndex(Index);
+            NodeIndices[Node->ID()] = TNodeIndex(Index);
+            Locations[Index] = GeographicUtils::ToFixed(Node->Location());
+        }
+        BuildGraph(streetmap, NodeIndices, Locations);
+        BindStops(bussystem, NodeIndices);
+        Distances.assign(StopIDs.size() * StopIDs.size(), NoPathDistance);
+    }
+
+    void BuildGraph(const CStreetMap &streetmap, const std::unordered_map<CStreetMap::TNodeID, TNodeIndex> &nodeindices, const std::vector<SFixedLocation> &locations) {
+        // collect directed edges of every highway, then pack them by source node
+        std::vector<std::pair<TNodeIndex, TNodeIndex>> Edges;
+        for (std::size_t Index = 0; Index < streetmap.WayCount(); Index++) {
+            auto Way = streetmap.WayByIndex(Index);
+            if (!Way->HasAttribute("highway")) {
+                continue;
+            }
+            std::string OneWay = Way->GetAttribute("oneway");
+            bool Forward = OneWay != "-1";
+            bool Backward = OneWay != "yes" && OneWay != "true" && OneWay != "1";
+            TNodeIndex Previous = InvalidNodeIndex;
+            for (std::size_t NodeIndex = 0; NodeIndex < Way->NodeCount(); NodeIndex++) {
+                auto Search = nodeindices.find(Way->GetNodeID(NodeIndex));
+                if (Search == nodeindices.end()) {
+                    continue; // skip refs to nodes outside of the extract
+                }
+                if (Previous != InvalidNodeIndex && Previous != Search->second) {
+                    if (Forward) {
+                        Edges.emplace_back(Previous, Search->second);
+                    }
+                    if (Backward) {
+                        Edges.emplace_back(Search->second, Previous);
+                    }
+                }
+                Previous = Search->second;
+            }
+        }
+
+        EdgeOffsets.assign(locations.size() + 1, 0);
+        for (auto &Edge : Edges) {
+            EdgeOffsets[Edge.first + 1]++;
+        }
+        for (std::size_t Index = 0; Index < locations.size(); Index++) {
+            EdgeOffsets[Index + 1] += EdgeOffsets[Index];
+        }
+        EdgeTargets.resize(Edges.size());
+        EdgeWeights.resize(Edges.size());
+        std::vector<TNodeIndex> EdgeSources(Edges.size());
+        std::vector<std::size_t> Fill(EdgeOffsets.begin(), EdgeOffsets.end() - 1);
+        for (auto &Edge : Edges) {
+            std::size_t Slot = Fill[Edge.first]++;
+            EdgeSources[Slot] = Edge.first;
+            EdgeTargets[Slot] = Edge.second;
+        }
+        // weights in one pass so each node's latitude cosine is computed once rather than per edge
+        GeographicUtils::HaversineDistances(locations.data(), locations.size(), EdgeSources.data(), EdgeTargets.data(), Edges.size(), EdgeWeights.data());
+    }
+
+    void BindStops(const CBusSystem &bussystem, const std::unordered_map<CStreetMap::TNodeID, TNodeIndex> &nodeindices) {
+        TargetNodes.assign(EdgeOffsets.size() - 1, 0);
+        for (std::size_t Index = 0; Index < bussystem.StopCount(); Index++) {
+            auto Stop = bussystem.StopHandleByIndex(Index);
+            auto Search = nodeindices.find(Stop->NodeID());
+            TNodeIndex Node = Search == nodeindices.end() ? InvalidNodeIndex : Search->second;
+            StopIndices[Stop->ID()] = StopIDs.size();
+            StopIDs.push_back(Stop->ID());
+            StopNodes.push_back(Node);
+            if (Node != InvalidNodeIndex && !TargetNodes[Node]) {
+                TargetNodes[Node] = 1;
+                TargetNodeCount++;
+            }
+        }
+    }
+
+    // one-to-many dijkstra that stops as soon as every stop node has been settled
+    void Search(std::size_t srcindex, SSearchState &state) {
+        double *Row = Distances.data() + srcindex * StopIDs.size();
+        Row[srcindex] = 0.0;
+        TNodeIndex Source = StopNodes[srcindex];
+        if (Source == InvalidNodeIndex) {
+            return;
+        }
+
+        using TQueueEntry = std::pair<double, TNodeIndex>;
+        std::priority_queue<TQueueEntry, std::vector<TQueueEntry>, std::greater<TQueueEntry>> Queue;
+        std::size_t Remaining = TargetNodeCount;
+        state.NodeDistances[Source] = 0.0;
+        state.Touched.push_back(Source);
+        Queue.emplace(0.0, Source);
+        while (!Queue.empty() && Remaining) {
+            auto Current = Queue.top();
+            Queue.pop();
+            if (state.Settled[Current.second]) {
+                continue;
+            }
+            state.Settled[Current.second] = 1;
+            if (TargetNodes[Current.second]) {
+                Remaining--;
+            }
+            for (std::size_t Edge = EdgeOffsets[Current.second]; Edge < EdgeOffsets[Current.second + 1]; Edge++) {
+                TNodeIndex Next = EdgeTargets[Edge];
+                double Candidate = Current.first + EdgeWeights[Edge];
+                if (Candidate < state.NodeDistances[Next]) {
+                    if (state.NodeDistances[Next] == NoPathDistance) {
+                        state.Touched.push_back(Next);
+                    }
+                    state.NodeDistances[Next] = Candidate;
+                    Queue.emplace(Candidate, Next);
+                }
+            }
+        }
+
+        for (std::size_t Index = 0; Index < StopNodes.size(); Index++) {
+            if (StopNodes[Index] != InvalidNodeIndex && state.Settled[StopNodes[Index]]) {
+                Row[Index] = state.NodeDistances[StopNodes[Index]];
+            }
+        }
+        for (auto Node : state.Touched) {
+            state.NodeDistances[Node] = NoPathDistance;
+            state.Settled[Node] = 0;
+        }
+        state.Touched.clear();
+    }
+
+    bool Compute(std::size_t threadcount) {
+        if (threadcount == 0) {
+            threadcount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threadcount = std::min(threadcount, std::max<std::size_t>(1, StopIDs.size()));
+        std::fill(Distances.begin(), Distances.end(), NoPathDistance);
+        Computed = false;
+
+        // workers pull the next source stop from a shared counter
+        std::atomic<std::size_t> NextSource(0);
+        auto Worker = [this, &NextSource]() {
+            SSearchState State;
+            State.NodeDistances.assign(TargetNodes.size(), NoPathDistance);
+            State.Settled.assign(TargetNodes.size(), 0);
+            for (std::size_t Source = NextSource++; Source < StopIDs.size(); Source = NextSource++) {
+                Search(Source, State);
+            }
+        };
+        std::vector<std::thread> Threads;
+        try {
+            for (std::size_t Index = 1; Index < threadcount; Index++) {
+                Threads.emplace_back(Worker);
+            }
+        } catch (const std::system_error &) {
+            // threads that did start drain the counter and must be joined before they are destroyed
+            NextSource = StopIDs.size();
+            for (auto &Thread : Threads) {
+                Thread.join();
+            }
+            return false;
+        }
+        Worker();
+        for (auto &Thread : Threads) {
+            Thread.join();
+        }
+        Computed = true;
+        return true;
+    }
+};
+
+CStopDistanceMatrix::CStopDistanceMatrix(std::shared_ptr<CStreetMap> streetmap, std::shared_ptr<CBusSystem> bussystem) {
+    if (!streetmap || !bussystem) {
+        throw std::invalid_argument("streetmap and bussystem must not be null");
+    }
+    DImplementation = std::make_unique<SImplementation>(*streetmap, *bussystem);
+}
+
+CStopDistanceMatrix::~CStopDistanceMatrix() = default;
+
+std::size_t CStopDistanceMatrix::StopCount() const noexcept {
+    return DImplementation->StopIDs.size();
+}
+
+CBusSystem::TStopID CStopDistanceMatrix::StopID(std::size_t index) const noexcept {
+    if (index < DImplementation->StopIDs.size()) {
+        return DImplementation->StopIDs[index];
+    }
+    return CBusSystem::InvalidStopID;
+}
+
+bool CStopDistanceMatrix::Compute(std::size_t threadcount) {
+    return DImplementation->Compute(threadcount);
+}
+
+double CStopDistanceMatrix::Distance(std::size_t srcindex, std::size_t destindex) const noexcept {
+    std::size_t Count = DImplementation->StopIDs.size();
+    if (!DImplementation->Computed || srcindex >= Count || destindex >= Count) {
+        return NoPathDistance;
+    }
+    return DImplementation->Distances[srcindex * Count + destindex];
+}
+
+double CStopDistanceMatrix::DistanceByID(CBusSystem::TStopID src, CBusSystem::TStopID dest) const noexcept {
+    auto Source = DImplementation->StopIndices.find(src);
+    auto Destination = DImplementation->StopIndices.find(dest);
+    if (Source == DImplementation->StopIndices.end() || Destination == DImplementation->StopIndices.end()) {
+        return NoPathDistance;
+    }
+    return Distance(Source->second, Destination->second);
+}
+
+bool CStopDistanceMatrix::Write(std::shared_ptr<CDSVWriter> writer) const {
+    if (!writer || !DImplementation->Computed) {
+        return false;
+    }
+    std::size_t Count = DImplementation->StopIDs.size();
+    std::vector<std::string> Row;
+    Row.reserve(Count + 1);
+    Row.push_back("stop_id");
+    for (auto StopID : DImplementation->StopIDs) {
+        Row.push_back(std::to_string(StopID));
+    }
+    if (!writer->WriteRow(Row)) {
+        return false;
+    }
+    char Buffer[32];
+    for (std::size_t Source = 0; Source < Count; Source++) {
+        Row.clear();
+        Row.push_back(std::to_string(DImplementation->StopIDs[Source]));
+        for (std::size_t Destination = 0; Destination < Count; Destination++) {
+            double Value = DImplementation->Distances[Source * Count + Destination];
+            if (Value == NoPathDistance) {
+                Row.emplace_back();
+            } else {
+                std::snprintf(Buffer, sizeof(Buffer), "%.1f", Value);
+                Row.emplace_back(Buffer);
+            }
+        }
+        if (!writer->WriteRow(Row)) {
+            return false;
+        }
+    }
+    return true;
+}
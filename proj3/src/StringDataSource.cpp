@@ -1,4 +1,5 @@
 #include "StringDataSource.h"
+#include <algorithm>
 
 CStringDataSource::CStringDataSource(const std::string &str) : DString(str), DIndex(0){
 
@@ -26,15 +27,24 @@ bool CStringDataSource::Peek(char &ch) noexcept{
 }
 
 bool CStringDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
-    buf.clear();
-    while(buf.size() < count){
-        char TempChar;
-        if(Get(TempChar)){
-            buf.push_back(TempChar);
-        }
-        else{
-            break;
-        }
-    }
+    std::size_t Length = DIndex < DString.length() ? std::min(count, DString.length() - DIndex) : 0;
+    buf.assign(DString.begin() + DIndex, DString.begin() + DIndex + Length);
+    DIndex += Length;
     return !buf.empty();
 }
+
+std::size_t CStringDataSource::Size() const noexcept{
+    return DString.length();
+}
+
+std::size_t CStringDataSource::Tell() const noexcept{
+    return DIndex;
+}
+
+bool CStringDataSource::Seek(std::size_t position) noexcept{
+    if(position > DString.length()){
+        return false;
+    }
+    DIndex = position;
+    return true;
+}
@@ -1,293 +1,713 @@
 #include "StringUtils.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace StringUtils
 {
 
-    std::string Slice(const std::string &str, ssize_t start, ssize_t end) noexcept
+    namespace
     {
-        if (start < 0)
+        // inputs at least this long amortize building a CPattern inside Replace and Split
+        const size_t CompiledSearchThreshold = 256;
+
+        inline bool IsStripSpace(char c) noexcept
         {
-            start = str.size() + start;
+            return c == ' ' || (c >= '\t' && c <= '\r');
         }
-        if (end < 0)
+
+        // flips the case of every ascii letter in [first, last) in place, toupper when upper is true
+        void AsciiCase(char *first, char *last, bool upper) noexcept
         {
-            end = str.size() + end;
+            const char low = upper ? 'a' : 'A';
+#if defined(__SSE2__)
+            // shift the letter range to the bottom of the signed range so one compare finds it
+            const __m128i shift = _mm_set1_epi8(char(0x80 - low));
+            const __m128i limit = _mm_set1_epi8(char(0x80 + 26));
+            const __m128i flip = _mm_set1_epi8(0x20);
+            for (; last - first >= 16; first += 16)
+            {
+                __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                __m128i letters = _mm_cmplt_epi8(_mm_add_epi8(chars, shift), limit);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(first), _mm_xor_si128(chars, _mm_and_si128(letters, flip)));
+            }
+#endif
+            for (; first != last; first++)
+            {
+                if (*first >= low && *first < low + 26)
+                {
+                    *first ^= 0x20;
+                }
+            }
         }
-        auto len = (end - start);
-        return str.substr(start, len);
+
+        size_t FirstNonSpace(std::string_view str) noexcept
+        {
+            size_t i = 0;
+#if defined(__SSE2__)
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i shift = _mm_set1_epi8(char(0x80 - '\t'));
+            const __m128i limit = _mm_set1_epi8(char(0x80 + 5));
+            for (; i + 16 <= str.size(); i += 16)
+            {
+                __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str.data() + i));
+                __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmplt_epi8(_mm_add_epi8(chars, shift), limit));
+                unsigned mask = ~unsigned(_mm_movemask_epi8(spaces)) & 0xFFFF;
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+#endif
+            while (i < str.size() && IsStripSpace(str[i]))
+            {
+                i++;
+            }
+            return i;
+        }
+
+        size_t EndNonSpace(std::string_view str) noexcept
+        {
+            size_t len = str.size();
+#if defined(__SSE2__)
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i shift = _mm_set1_epi8(char(0x80 - '\t'));
+            const __m128i limit = _mm_set1_epi8(char(0x80 + 5));
+            for (; len >= 16; len -= 16)
+            {
+                __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str.data() + len - 16));
+                __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmplt_epi8(_mm_add_epi8(chars, shift), limit));
+                unsigned mask = ~unsigned(_mm_movemask_epi8(spaces)) & 0xFFFF;
+                if (mask)
+                {
+                    return len - 16 + (31 - __builtin_clz(mask)) + 1;
+                }
+            }
+#endif
+            while (len > 0 && IsStripSpace(str[len - 1]))
+            {
+                len--;
+            }
+            return len;
+        }
+    }
+
+    std::string Slice(const std::string &str, ssize_t start, ssize_t end) noexcept
+    {
+        return std::string(SliceView(str, start, end));
     }
 
     std::string Capitalize(const std::string &str) noexcept
     {
-        std::string res = str;
-        res[0] = toupper(res[0]);
-        for (size_t i = 1; i < res.size(); i++)
-        {
-            res[i] = tolower(res[i]);
-        }
+        std::string res;
+        CapitalizeTo(res, str);
         return res;
     }
 
     std::string Upper(const std::string &str) noexcept
     {
-        std::string res = str;
-        for (size_t i = 0; i < res.size(); i++)
-        {
-            res[i] = toupper(res[i]);
-        }
+        std::string res;
+        UpperTo(res, str);
         return res;
     }
 
     std::string Lower(const std::string &str) noexcept
     {
-        std::string res = str;
-        for (size_t i = 0; i < str.size(); i++)
-        {
-            res[i] = tolower(res[i]);
-        }
+        std::string res;
+        LowerTo(res, str);
         return res;
     }
 
     std::string LStrip(const std::string &str) noexcept
     {
-        auto i = 0;
-        while (str[i] == ' ')
-        {
-            i++;
-        }
-        return str.substr(i);
+        return std::string(LStripView(str));
     }
 
     std::string RStrip(const std::string &str) noexcept
     {
-        auto i = str.length() - 1;
-        while (i >= 0 && str[i] == ' ')
-        {
-            i--;
-        }
-        int len = i + 1;
-        return str.substr(0, len);
+        return std::string(RStripView(str));
     }
 
     std::string Strip(const std::string &str) noexcept
     {
-        auto i = 0;
-        while (str[i] == ' ')
+        return std::string(StripView(str));
+    }
+
+    std::string Center(const std::string &str, int width, char fill) noexcept
+    {
+        std::string res;
+        CenterTo(res, str, width, fill);
+        return res;
+    }
+
+    std::string LJust(const std::string &str, int width, char fill) noexcept
+    {
+        std::string res;
+        LJustTo(res, str, width, fill);
+        return res;
+    }
+
+    std::string RJust(const std::string &str, int width, char fill) noexcept
+    {
+        std::string res;
+        RJustTo(res, str, width, fill);
+        return res;
+    }
+
+    std::string Replace(const std::string &str, const std::string &old, const std::string &rep) noexcept
+    {
+        std::string res;
+        ReplaceTo(res, str, old, rep);
+        return res;
+    }
+
+    std::vector<std::string> Split(const std::string &str, const std::string &splt) noexcept
+    {
+        if (!splt.empty() && str.size() >= CompiledSearchThreshold)
         {
-            i++;
+            return CPattern(splt).Split(str);
         }
-        auto c = str.length() - 1;
-        while (c >= 0 && str[c] == ' ')
+        std::vector<std::string> v;
+        for (auto piece : SplitView(str, splt))
         {
-            c--;
+            v.emplace_back(piece);
         }
-        int len = c - i + 1;
-        return str.substr(i, len);
+        return v;
     }
 
-    std::string Center(const std::string &str, int width, char fill) noexcept
+    std::string Join(const std::string &str, const std::vector<std::string> &vect) noexcept
     {
-        std::string res = str;
-        int leftspace = (width - str.length()) / 2; // had to add this first part b/c of failed tests
-        int rightspace = (width - str.length()) / 2;
-        if ((width - str.length()) % 2 != 0)
+        std::string res;
+        JoinTo(res, str, vect);
+        return res;
+    }
+
+    std::string ExpandTabs(const std::string &str, int tabsize) noexcept
+    {
+        std::string res;
+        ExpandTabsTo(res, str, tabsize);
+        return res;
+    }
+
+    std::string_view SliceView(std::string_view str, ssize_t start, ssize_t end) noexcept
+    {
+        ssize_t size = str.size();
+        if (start < 0)
         {
-            rightspace = rightspace + 1;
+            start = std::max<ssize_t>(0, size + start);
         }
-
-        for (int i = 0; i < leftspace; i++)
+        // an end of 0 means slice to the end of the string
+        if (end <= 0)
         {
-            res = fill + res;
+            end = size + end;
         }
-        for (int i = 0; i < rightspace; i++)
+        start = std::min(start, size);
+        end = std::min(end, size);
+        if (end <= start)
         {
-            res = res + fill;
+            return std::string_view();
         }
-        return res;
+        return str.substr(start, end - start);
     }
 
-    std::string LJust(const std::string &str, int width, char fill) noexcept
+    std::string_view LStripView(std::string_view str) noexcept
     {
-        std::string res = str;
-        int ind = width - str.length();
-        for (int i = 0; i < ind; i++)
+        return str.substr(FirstNonSpace(str));
+    }
+
+    std::string_view RStripView(std::string_view str) noexcept
+    {
+        return str.substr(0, EndNonSpace(str));
+    }
+
+    std::string_view StripView(std::string_view str) noexcept
+    {
+        return RStripView(LStripView(str));
+    }
+
+    void CapitalizeTo(std::string &out, std::string_view str) noexcept
+    {
+        if (str.empty())
         {
-            res = res + fill;
+            return;
         }
-        return res;
+        size_t base = out.size();
+        out.append(str);
+        AsciiCase(&out[base], &out[base] + 1, true);
+        AsciiCase(&out[base] + 1, &out[0] + out.size(), false);
     }
 
-    std::string RJust(const std::string &str, int width, char fill) noexcept
+    void UpperTo(std::string &out, std::string_view str) noexcept
+    {
+        size_t base = out.size();
+        out.append(str);
+        AsciiCase(&out[0] + base, &out[0] + out.size(), true);
+    }
+
+    void LowerTo(std::string &out, std::string_view str) noexcept
+    {
+        size_t base = out.size();
+        out.append(str);
+        AsciiCase(&out[0] + base, &out[0] + out.size(), false);
+    }
+
+    std::string Capitalize(const std::string &str, const std::locale &locale) noexcept
     {
         std::string res = str;
-        int ind = width - str.length();
-        for (int i = 0; i < ind; i++)
+        if (!res.empty())
         {
-            res = fill + res;
+            auto &facet = std::use_facet<std::ctype<char>>(locale);
+            res[0] = facet.toupper(res[0]);
+            facet.tolower(&res[0] + 1, &res[0] + res.size());
         }
         return res;
     }
 
-    std::string Replace(const std::string &str, const std::string &old, const std::string &rep) noexcept
+    std::string Upper(const std::string &str, const std::locale &locale) noexcept
+    {
+        std::string res = str;
+        std::use_facet<std::ctype<char>>(locale).toupper(&res[0], &res[0] + res.size());
+        return res;
+    }
+
+    std::string Lower(const std::string &str, const std::locale &locale) noexcept
     {
         std::string res = str;
-        auto ind = str.find(old);
-        while (ind != std::string::npos)
+        std::use_facet<std::ctype<char>>(locale).tolower(&res[0], &res[0] + res.size());
+        return res;
+    }
+
+    void CenterTo(std::string &out, std::string_view str, int width, char fill) noexcept
+    {
+        int space = std::max(0, width - int(str.size()));
+        out.append(space / 2, fill); // the extra fill of an odd gap goes on the right
+        out.append(str);
+        out.append(space - space / 2, fill);
+    }
+
+    void LJustTo(std::string &out, std::string_view str, int width, char fill) noexcept
+    {
+        out.append(str);
+        out.append(std::max(0, width - int(str.size())), fill);
+    }
+
+    void RJustTo(std::string &out, std::string_view str, int width, char fill) noexcept
+    {
+        out.append(std::max(0, width - int(str.size())), fill);
+        out.append(str);
+    }
+
+    void ReplaceTo(std::string &out, std::string_view str, std::string_view old, std::string_view rep) noexcept
+    {
+        // an empty pattern matches between every character, as in python
+        if (old.empty())
         {
-            res = res.replace(ind, old.length(), rep);
-            ind = res.find(old);
+            out.append(rep);
+            for (char c : str)
+            {
+                out += c;
+                out.append(rep);
+            }
+            return;
         }
-        return res;
+        if (str.size() >= CompiledSearchThreshold)
+        {
+            CPattern(old).ReplaceTo(out, str, rep);
+            return;
+        }
+        // single left to right pass over non-overlapping matches
+        size_t start = 0;
+        size_t ind = str.find(old);
+        while (ind != std::string_view::npos)
+        {
+            out.append(str.substr(start, ind - start));
+            out.append(rep);
+            start = ind + old.size();
+            ind = str.find(old, start);
+        }
+        out.append(str.substr(start));
     }
 
-    std::vector<std::string> Split(const std::string &str, const std::string &splt) noexcept
+    void JoinTo(std::string &out, std::string_view str, const std::vector<std::string> &vect) noexcept
     {
-        std::vector<std::string> v; // Vector store stringds
-        std::string res = str;      // Make a copy of the input string to edit
+        for (size_t i = 0; i < vect.size(); i++)
+        {
+            if (i)
+            {
+                out.append(str);
+            }
+            out.append(vect[i]);
+        }
+    }
 
-        //if the delimiter is empty, split by whitespace
-        if (splt == "")
+    void ExpandTabsTo(std::string &out, std::string_view str, int tabsize) noexcept
+    {
+        size_t curr = 0;
+        for (char c : str)
         {
-            size_t start = 0; 
-            for (size_t i = 0; i < res.length(); i++)
+            if (c != '\t')
             {
-         
-                if (res[i] == ' '||res[i]=='\n'||res[i] == '\t')//|| res[i] == '\t' || res[i] == '\n tabs or new line i dnt think i need unless later 
-                {
-                    if (i > start)
-                    {
-                        v.push_back(res.substr(start, i - start)); // Add the word before the whitespace
-                    }
-                    start = i + 1;
-                }
+                out += c;
+                curr += 1;
             }
-            // Add the last part 
-            if (start < res.length())
+            else if (tabsize > 0)
             {
-                v.push_back(res.substr(start));
+                size_t numspaces = tabsize - (curr % tabsize);
+                out.append(numspaces, ' ');
+                curr += numspaces;
             }
         }
-        else // Case 2: If a specific delimiter is given, split by the delimiter
+    }
+
+    CSplitView::CSplitView(std::string_view str, std::string_view splt) noexcept : DString(str), DSeparator(splt), DPattern(nullptr)
+    {
+    }
+
+    CSplitView::CSplitView(std::string_view str, const CPattern &pattern) noexcept : DString(str), DSeparator(pattern.Pattern()), DPattern(&pattern)
+    {
+    }
+
+    CSplitView::CIterator CSplitView::begin() const noexcept
+    {
+        return CIterator(this, 0);
+    }
+
+    CSplitView::CIterator CSplitView::end() const noexcept
+    {
+        return CIterator(this, std::string_view::npos);
+    }
+
+    CSplitView SplitView(std::string_view str, std::string_view splt) noexcept
+    {
+        return CSplitView(str, splt);
+    }
+
+    CSplitView SplitView(std::string_view str, const CPattern &pattern) noexcept
+    {
+        return CSplitView(str, pattern);
+    }
+
+    namespace
+    {
+        inline bool IsSplitSpace(char c) noexcept
+        {
+            return c == ' ' || c == '\n' || c == '\t';
+        }
+    }
+
+    CSplitView::CIterator::CIterator(const CSplitView *view, size_t start) noexcept : DView(view), DStart(start), DEnd(start)
+    {
+        if (start != std::string_view::npos)
         {
-            size_t start = 0;
-            size_t ind = res.find(splt); // Find the first occurrence of the delimiter
+            Advance(start);
+        }
+    }
 
-            while (ind != std::string::npos) // Loop while we keep finding the delimiter
+    // finds the piece starting at or after from, DStart becomes npos when there are no more pieces
+    void CSplitView::CIterator::Advance(size_t from) noexcept
+    {
+        std::string_view str = DView->DString;
+        if (DView->DSeparator.empty())
+        {
+            // whitespace mode skips runs of whitespace and never yields empty pieces
+            while (from < str.size() && IsSplitSpace(str[from]))
             {
-                v.push_back(res.substr(start, ind - start)); // Extract substring before delimiter and store
-                start = ind + splt.length();                 // Move past the delimiter
-                ind = res.find(splt, start);                 // Find the next occurrence of the delimiter
+                from++;
             }
-
-            // Add the last part of the string after the last delimiter
-            v.push_back(res.substr(start));
+            if (from >= str.size())
+            {
+                DStart = DEnd = std::string_view::npos;
+                return;
+            }
+            DStart = DEnd = from;
+            while (DEnd < str.size() && !IsSplitSpace(str[DEnd]))
+            {
+                DEnd++;
+            }
+            return;
         }
+        DStart = from;
+        DEnd = std::min(DView->DPattern ? DView->DPattern->Find(str, from) : str.find(DView->DSeparator, from), str.size());
+    }
 
-        return v; // Return the vector containing the split parts
+    std::string_view CSplitView::CIterator::operator*() const noexcept
+    {
+        return DView->DString.substr(DStart, DEnd - DStart);
     }
 
-    std::string Join(const std::string &str, const std::vector<std::string> &vect) noexcept
+    CSplitView::CIterator &CSplitView::CIterator::operator++() noexcept
     {
-        std::string res = vect[0];
-        for (size_t i = 1; i < vect.size(); i++)
+        if (!DView->DSeparator.empty() && DEnd >= DView->DString.size())
         {
-            res += str + vect[i];
+            DStart = DEnd = std::string_view::npos;
         }
+        else
+        {
+            Advance(DView->DSeparator.empty() ? DEnd : DEnd + DView->DSeparator.size());
+        }
+        return *this;
+    }
+
+    CSplitView::CIterator CSplitView::CIterator::operator++(int) noexcept
+    {
+        CIterator res = *this;
+        ++*this;
         return res;
     }
 
-    std::string ExpandTabs(const std::string &str, int tabsize) noexcept
+    bool CSplitView::CIterator::operator==(const CIterator &other) const noexcept
     {
-        std::string res;
-        size_t curr = 0;
-        if (tabsize == 0)
+        return DView == other.DView && DStart == other.DStart;
+    }
+
+    bool CSplitView::CIterator::operator!=(const CIterator &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    CPattern::CPattern(std::string_view pattern) : DPattern(pattern)
+    {
+        // a character not in the pattern lets the window jump past it entirely
+        size_t len = DPattern.size();
+        for (auto &shift : DShift)
         {
-            for (char c : str)
+            shift = std::max<size_t>(1, len);
+        }
+        for (size_t i = 0; i + 1 < len; i++)
+        {
+            DShift[static_cast<unsigned char>(DPattern[i])] = len - 1 - i;
+        }
+    }
+
+    const std::string &CPattern::Pattern() const noexcept
+    {
+        return DPattern;
+    }
+
+    size_t CPattern::Find(std::string_view str, size_t pos) const noexcept
+    {
+        const size_t len = DPattern.size();
+        if (pos > str.size() || len > str.size() - pos)
+        {
+            return std::string_view::npos;
+        }
+        if (len == 0)
+        {
+            return pos;
+        }
+        const char *text = str.data();
+        const char *pattern = DPattern.data();
+        if (len == 1)
+        {
+            auto found = static_cast<const char *>(memchr(text + pos, pattern[0], str.size() - pos));
+            return found ? found - text : std::string_view::npos;
+        }
+        size_t i = pos;
+#if defined(__SSE2__)
+        // short patterns rarely allow long horspool jumps, so filter 16 windows at a time on their first and last bytes
+        if (len <= 32)
+        {
+            const __m128i first = _mm_set1_epi8(pattern[0]);
+            const __m128i last = _mm_set1_epi8(pattern[len - 1]);
+            for (; i + len - 1 + 16 <= str.size(); i += 16)
             {
-                if (c != '\t')
+                __m128i starts = _mm_cmpeq_epi8(first, _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i)));
+                __m128i ends = _mm_cmpeq_epi8(last, _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i + len - 1)));
+                unsigned mask = _mm_movemask_epi8(_mm_and_si128(starts, ends));
+                while (mask)
                 {
-                    res += c;
+                    size_t candidate = i + __builtin_ctz(mask);
+                    if (memcmp(text + candidate + 1, pattern + 1, len - 2) == 0)
+                    {
+                        return candidate;
+                    }
+                    mask &= mask - 1;
                 }
             }
-            return res;
         }
-        for (char c : str)
+#endif
+        const char tail = pattern[len - 1];
+        while (i <= str.size() - len)
         {
-            if (c == '\t')
+            char c = text[i + len - 1];
+            if (c == tail && memcmp(text + i, pattern, len - 1) == 0)
             {
-                size_t numspaces = tabsize - (curr % tabsize);
-                res.append(numspaces, ' ');
-                curr += numspaces;
-            }
-            else
-            {
-                res += c;
-                curr += 1;
+                return i;
             }
+            i += DShift[static_cast<unsigned char>(c)];
+        }
+        return std::string_view::npos;
+    }
+
+    size_t CPattern::Count(std::string_view str) const noexcept
+    {
+        if (DPattern.empty())
+        {
+            return str.size() + 1;
         }
+        size_t count = 0;
+        for (size_t ind = Find(str); ind != std::string_view::npos; ind = Find(str, ind + DPattern.size()))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    std::string CPattern::Replace(const std::string &str, const std::string &rep) const noexcept
+    {
+        std::string res;
+        ReplaceTo(res, str, rep);
         return res;
     }
 
-    int EditDistance(const std::string &left, const std::string &right, bool ignorecase) noexcept
+    void CPattern::ReplaceTo(std::string &out, std::string_view str, std::string_view rep) const noexcept
     {
-        // Replace code here
-        std::string leftTemp = left;
-        std::string rightTemp = right;
-        // must be lowercase if ignorecase is true
-        if (ignorecase)
+        if (DPattern.empty())
+        {
+            StringUtils::ReplaceTo(out, str, DPattern, rep);
+            return;
+        }
+        size_t start = 0;
+        for (size_t ind = Find(str); ind != std::string_view::npos; ind = Find(str, start))
         {
-            leftTemp = StringUtils::Lower(left);
-            rightTemp = StringUtils::Lower(right);
+            out.append(str.substr(start, ind - start));
+            out.append(rep);
+            start = ind + DPattern.size();
         }
-        // now get the length actual sizes of the strings
-        size_t leftSize = leftTemp.size();
-        size_t rightSize = rightTemp.size();
-        // create 2D vector to hold the distances of the strings
-        std::vector<std::vector<int>> distance(leftSize + 1, std::vector<int>(rightSize + 1));
-        // now this should look like a table
+        out.append(str.substr(start));
+    }
 
-        for (size_t i = 0; i <= leftSize; i++)
+    std::vector<std::string> CPattern::Split(const std::string &str) const noexcept
+    {
+        std::vector<std::string> v;
+        for (auto piece : SplitView(str, *this))
         {
-            distance[i][0] = i;
+            v.emplace_back(piece);
         }
-        // this is for the inital row
-        for (size_t j = 0; j <= rightSize; j++)
+        return v;
+    }
+
+    namespace
+    {
+        // ascii case folding, matches tolower in the default "C" locale without a call per byte
+        inline unsigned char FoldCase(unsigned char ch, bool ignorecase) noexcept
         {
-            distance[0][j] = j;
+            return (ignorecase && ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
         }
-        // fill rest of the table
-        for (size_t i = 1; i <= leftSize; i++)
+
+        // Myers/Hyyro bit-parallel distance, pattern must be 1 to 64 characters
+        int BitParallelDistance(const unsigned char *pattern, size_t patternSize, const unsigned char *text, size_t textSize, bool ignorecase, int maxdistance) noexcept
         {
-            for (size_t j = 1; j <= rightSize; j++)
+            uint64_t Peq[256] = {0};
+            for (size_t i = 0; i < patternSize; i++)
+            {
+                Peq[FoldCase(pattern[i], ignorecase)] |= uint64_t(1) << i;
+            }
+            uint64_t Pv = ~uint64_t(0);
+            uint64_t Mv = 0;
+            uint64_t Last = uint64_t(1) << (patternSize - 1);
+            int Score = patternSize;
+            for (size_t j = 0; j < textSize; j++)
             {
-                int temp = 1;
-                if (leftTemp[i - 1] == rightTemp[j - 1])
+                uint64_t Eq = Peq[FoldCase(text[j], ignorecase)];
+                uint64_t Xv = Eq | Mv;
+                uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+                uint64_t Ph = Mv | ~(Xh | Pv);
+                uint64_t Mh = Pv & Xh;
+                if (Ph & Last)
                 {
-                    temp = 0;
+                    Score++;
                 }
-
-                int insertion = distance[i][j - 1] + 1;
-                int deletion = distance[i - 1][j] + 1;
-                int substitution = distance[i - 1][j - 1] + temp;
-                // these are all the costs of the operations
-
-                if (insertion <= deletion && insertion <= substitution)
+                else if (Mh & Last)
+                {
+                    Score--;
+                }
+                // each remaining column lowers the score by at most one
+                if (maxdistance >= 0 && Score - int(textSize - j - 1) > maxdistance)
                 {
-                    distance[i][j] = insertion;
+                    return maxdistance + 1;
                 }
-                else if (deletion <= insertion && deletion <= substitution)
+                Ph = (Ph << 1) | 1;
+                Mh <<= 1;
+                Pv = Mh | ~(Xv | Ph);
+                Mv = Ph & Xv;
+            }
+            return Score;
+        }
+
+        // two row dynamic programming over the shorter string for patterns longer than a machine word
+        int TwoRowDistance(const unsigned char *pattern, size_t patternSize, const unsigned char *text, size_t textSize, bool ignorecase, int maxdistance) noexcept
+        {
+            std::vector<int> Row(patternSize + 1);
+            for (size_t i = 0; i <= patternSize; i++)
+            {
+                Row[i] = i;
+            }
+            for (size_t j = 1; j <= textSize; j++)
+            {
+                int Diagonal = Row[0];
+                Row[0] = j;
+                int RowMinimum = Row[0];
+                unsigned char TextChar = FoldCase(text[j - 1], ignorecase);
+                for (size_t i = 1; i <= patternSize; i++)
                 {
-                    distance[i][j] = deletion;
+                    int Above = Row[i];
+                    int Cost = FoldCase(pattern[i - 1], ignorecase) == TextChar ? 0 : 1;
+                    Row[i] = std::min(std::min(Row[i - 1] + 1, Above + 1), Diagonal + Cost);
+                    Diagonal = Above;
+                    RowMinimum = std::min(RowMinimum, Row[i]);
                 }
-                else
+                // the smallest value in a row never decreases in later rows, so once every cell is over the limit the result is too
+                if (maxdistance >= 0 && RowMinimum > maxdistance)
                 {
-                    distance[i][j] = substitution;
+                    return maxdistance + 1;
                 }
-                // this is the minimum of the three
             }
+            return Row[patternSize];
+        }
+    }
+
+    int EditDistance(const std::string &left, const std::string &right, bool ignorecase, int maxdistance) noexcept
+    {
+        const unsigned char *Left = reinterpret_cast<const unsigned char *>(left.data());
+        const unsigned char *Right = reinterpret_cast<const unsigned char *>(right.data());
+        size_t LeftSize = left.size();
+        size_t RightSize = right.size();
+        // the length difference alone is a lower bound on the distance
+        size_t LengthGap = LeftSize > RightSize ? LeftSize - RightSize : RightSize - LeftSize;
+        if (maxdistance >= 0 && LengthGap > size_t(maxdistance))
+        {
+            return maxdistance + 1;
+        }
+        // a shared prefix or suffix never changes the distance, so trim it first
+        while (LeftSize && RightSize && FoldCase(*Left, ignorecase) == FoldCase(*Right, ignorecase))
+        {
+            Left++;
+            Right++;
+            LeftSize--;
+            RightSize--;
+        }
+        while (LeftSize && RightSize && FoldCase(Left[LeftSize - 1], ignorecase) == FoldCase(Right[RightSize - 1], ignorecase))
+        {
+            LeftSize--;
+            RightSize--;
+        }
+        if (LeftSize > RightSize)
+        {
+            std::swap(Left, Right);
+            std::swap(LeftSize, RightSize);
+        }
+        if (LeftSize == 0)
+        {
+            return (maxdistance >= 0 && RightSize > size_t(maxdistance)) ? maxdistance + 1 : int(RightSize);
+        }
+        if (LeftSize <= 64)
+        {
+            return BitParallelDistance(Left, LeftSize, Right, RightSize, ignorecase, maxdistance);
         }
-        // now we have the table filled out, so we can return the last element
-        // this is the distance between the two strings
-        return distance[leftSize][rightSize];
+        return TwoRowDistance(Left, LeftSize, Right, RightSize, ignorecase, maxdistance);
     }
 };
\ No newline at end of file
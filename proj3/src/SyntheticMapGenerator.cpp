@@ -0,0 +1,264 @@
+#include "SyntheticMapGenerator.h"
+#include "XMLWriter.h"
+#include "DSVWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct CSyntheticMapGenerator::SImplementation {
+    static constexpr CStreetMap::TNodeID BaseNodeID = 100000000;
+    static constexpr CStreetMap::TWayID BaseWayID = 5000000;
+    static constexpr uint64_t BaseStopID = 22000;
+
+    std::size_t NodeCount;
+    uint64_t Seed;
+    std::size_t StopCount;
+    std::size_t RouteCount;
+    std::size_t Columns;
+    std::size_t Rows;
+    std::size_t WayCount = 0;
+
+    // stateless hash so every element can be regenerated from its index alone
+    uint64_t Mix(uint64_t a, uint64_t b = 0) const {
+        uint64_t Value = Seed * 0x9E3779B97F4A7C15ULL + a * 0xBF58476D1CE4E5B9ULL + b * 0x94D049BB133111EBULL;
+        Value ^= Value >> 30;
+        Value *= 0xBF58476D1CE4E5B9ULL;
+        Value ^= Value >> 27;
+        Value *= 0x94D049BB133111EBULL;
+        return Value ^ (Value >> 31);
+    }
+
+    SImplementation(std::size_t nodecount, uint64_t seed, std::size_t stopcount, std::size_t routecount) : NodeCount(nodecount), Seed(seed) {
+        Columns = std::max<std::size_t>(1, std::ceil(std::sqrt(double(NodeCount))));
+        Rows = (NodeCount + Columns - 1) / Columns;
+        StopCount = stopcount ? stopcount : std::max<std::size_t>(10, NodeCount / 400);
+        StopCount = std::min(StopCount, NodeCount);
+        RouteCount = routecount ? routecount : std::max<std::size_t>(2, StopCount / 20);
+        ForEachWay([this](std::size_t, bool, std::size_t, std::size_t, std::size_t) {
+            WayCount++;
+        });
+    }
+
+    // ids ascend with the index but leave random gaps, like an extract of a larger database
+    CStreetMap::TNodeID NodeID(std::size_t index) const {
+        return BaseNodeID + index * 4 + (Mix(index, 11) & 3);
+    }
+
+    std::size_t RowLength(std::size_t row) const {
+        return row + 1 < Rows ? Columns : NodeCount - (Rows - 1) * Columns;
+    }
+
+    std::size_t ColumnLength(std::size_t column) const {
+        return column < RowLength(Rows - 1) ? Rows : Rows - 1;
+    }
+
+    // streets run along every row and then every column, split into blocks of 10 to 40 nodes that share end nodes
+    template <typename TCallback>
+    void ForEachWay(TCallback callback) const {
+        std::size_t WayIndex = 0;
+        for (int Horizontal = 1; Horizontal >= 0; Horizontal--) {
+            std::size_t Lines = Horizontal ? Rows : Columns;
+            for (std::size_t Line = 0; Line < Lines; Line++) {
+                std::size_t Length = Horizontal ? RowLength(Line) : ColumnLength(Line);
+                for (std::size_t Start = 0; Start + 1 < Length;) {
+                    std::size_t End = std::min(Length - 1, Start + 10 + Mix(Line * 2 + Horizontal, Start) % 31);
+                    callback(WayIndex++, Horizontal != 0, Line, Start, End);
+                    Start = End;
+                }
+            }
+        }
+    }
+
+    static std::string Letters(std::size_t index) {
+        std::string Name;
+        do {
+            Name.insert(Name.begin(), char('A' + index % 26));
+            index = index / 26;
+        } while (index-- > 0);
+        return Name;
+    }
+
+    static std::string Ordinal(std::size_t number) {
+        const char *Suffix = "th";
+        if (number % 100 < 11 || number % 100 > 13) {
+            Suffix = number % 10 == 1 ? "st" : number % 10 == 2 ? "nd" : number % 10 == 3 ? "rd" : "th";
+        }
+        return std::to_string(number) + Suffix;
+    }
+
+    bool WriteOSM(std::shared_ptr<CDataSink> sink) const {
+        std::string Declaration = "<?xml version='1.0' encoding='UTF-8'?>\n";
+        if (!sink->Write(std::vector<char>(Declaration.begin(), Declaration.end()))) {
+            return false;
+        }
+        CXMLWriter Writer(sink);
+        SXMLEntity Entity;
+        char Buffer[32];
+        auto Indent = [&Writer](const char *text) {
+            SXMLEntity Space;
+            Space.DType = SXMLEntity::EType::CharData;
+            Space.DNameData = text;
+            return Writer.WriteEntity(Space);
+        };
+        auto Element = [&Entity](SXMLEntity::EType type, const char *name) {
+            Entity.DType = type;
+            Entity.DNameData = name;
+            Entity.DAttributes.clear();
+        };
+        auto Tag = [&](const std::string &key, const std::string &value) {
+            Element(SXMLEntity::EType::CompleteElement, "tag");
+            Entity.DAttributes = {{"k", key}, {"v", value}};
+            return Indent("\n\t\t") && Writer.WriteEntity(Entity);
+        };
+        auto Coordinate = [&Buffer](double value) {
+            std::snprintf(Buffer, sizeof(Buffer), "%.7f", value);
+            return std::string(Buffer);
+        };
+
+        Element(SXMLEntity::EType::StartElement, "osm");
+        Entity.DAttributes = {{"version", "0.6"}, {"generator", "CSyntheticMapGenerator"}};
+        bool Success = Writer.WriteEntity(Entity);
+        Element(SXMLEntity::EType::CompleteElement, "bounds");
+        Entity.DAttributes = {{"minlat", Coordinate(38.5)}, {"minlon", Coordinate(-121.8)},
+                              {"maxlat", Coordinate(38.5 + Rows * 0.0009)}, {"maxlon", Coordinate(-121.8 + Columns * 0.0011)}};
+        Success = Success && Indent("\n\t") && Writer.WriteEntity(Entity);
+
+        for (std::size_t Index = 0; Success && Index < NodeCount; Index++) {
+            double Latitude = 38.5 + (Index / Columns) * 0.0009 + (int(Mix(Index, 1) % 2001) - 1000) * 1e-7;
+            double Longitude = -121.8 + (Index % Columns) * 0.0011 + (int(Mix(Index, 2) % 2001) - 1000) * 1e-7;
+            // most nodes carry no tags, a few percent are signals, crossings or bus stops
+            uint64_t Kind = Mix(Index, 3) % 1000;
+            bool Tagged = Kind < 30;
+            Element(Tagged ? SXMLEntity::EType::StartElement : SXMLEntity::EType::CompleteElement, "node");
+            Entity.DAttributes = {{"id", std::to_string(NodeID(Index))}, {"lat", Coordinate(Latitude)}, {"lon", Coordinate(Longitude)},
+                                  {"version", std::to_string(1 + Mix(Index, 4) % 9)}};
+            Success = Indent("\n\t") && Writer.WriteEntity(Entity);
+            if (Success && Tagged) {
+                if (Kind < 15) {
+                    Success = Tag("highway", "traffic_signals");
+                } else if (Kind < 24) {
+                    Success = Tag("highway", "crossing") && Tag("crossing", Kind & 1 ? "zebra" : "uncontrolled");
+                } else {
+                    Success = Tag("highway", "bus_stop") && Tag("name", "Stop " + std::to_string(Index)) && Tag("shelter", Kind & 1 ? "yes" : "no");
+                }
+                Element(SXMLEntity::EType::EndElement, "node");
+                Success = Success && Indent("\n\t") && Writer.WriteEntity(Entity);
+            }
+        }
+
+        ForEachWay([&](std::size_t wayindex, bool horizontal, std::size_t line, std::size_t start, std::size_t end) {
+            if (!Success) {
+                return;
+            }
+            Element(SXMLEntity::EType::StartElement, "way");
+            Entity.DAttributes = {{"id", std::to_string(BaseWayID + wayindex * 2 + (Mix(wayindex, 5) & 1))}, {"version", std::to_string(1 + Mix(wayindex, 6) % 9)}};
+            Success = Indent("\n\t") && Writer.WriteEntity(Entity);
+            for (std::size_t Position = start; Success && Position <= end; Position++) {
+                std::size_t Index = horizontal ? line * Columns + Position : Position * Columns + line;
+                Element(SXMLEntity::EType::CompleteElement, "nd");
+                Entity.DAttributes = {{"ref", std::to_string(NodeID(Index))}};
+                Success = Indent("\n\t\t") && Writer.WriteEntity(Entity);
+            }
+            uint64_t Kind = Mix(wayindex, 7) % 100;
+            if (Kind < 4) {
+                Success = Success && Tag("highway", "service");
+            } else {
+                const char *Class = line % 10 == 0 ? "primary" : line % 5 == 0 ? "secondary" : "residential";
+                Success = Success && Tag("highway", Class);
+                Success = Success && Tag("name", horizontal ? Ordinal(line + 1) + " Street" : Letters(line) + " Street");
+                if (line % 5 == 0) {
+                    Success = Success && Tag("lanes", line % 10 == 0 ? "4" : "2") && Tag("maxspeed", line % 10 == 0 ? "35 mph" : "30 mph");
+                }
+                if (Kind < 12) {
+                    Success = Success && Tag("oneway", "yes");
+                }
+                if (Kind >= 60) {
+                    Success = Success && Tag("surface", "asphalt");
+                }
+            }
+            Element(SXMLEntity::EType::EndElement, "way");
+            Success = Success && Indent("\n\t") && Writer.WriteEntity(Entity);
+        });
+
+        Element(SXMLEntity::EType::EndElement, "osm");
+        return Success && Indent("\n") && Writer.WriteEntity(Entity) && Indent("\n");
+    }
+
+    // stops are spread evenly through the node order so neighbouring stops are close on the grid
+    std::size_t StopNodeIndex(std::size_t stop) const {
+        std::size_t Spacing = NodeCount / StopCount;
+        return stop * Spacing + Mix(stop, 8) % Spacing;
+    }
+
+    bool WriteStops(std::shared_ptr<CDataSink> sink) const {
+        CDSVWriter Writer(sink, ',');
+        bool Success = Writer.WriteRow({"stop_id", "node_id"});
+        for (std::size_t Stop = 0; Success && Stop < StopCount; Stop++) {
+            Success = Writer.WriteRow({std::to_string(BaseStopID + Stop), std::to_string(NodeID(StopNodeIndex(Stop)))});
+        }
+        return Success;
+    }
+
+    // each route walks forward through nearby stops, so routes overlap and share transfer stops
+    bool WriteRoutes(std::shared_ptr<CDataSink> sink) const {
+        CDSVWriter Writer(sink, ',');
+        bool Success = Writer.WriteRow({"route", "stop_id"});
+        for (std::size_t Route = 0; Success && Route < RouteCount; Route++) {
+            std::string Name = Letters(Route);
+            std::size_t Stops = std::min<std::size_t>(StopCount, 10 + Mix(Route, 9) % 31);
+            std::size_t Stop = Mix(Route, 10) % StopCount;
+            for (std::size_t Index = 0; Success && Index < Stops; Index++) {
+                Success = Writer.WriteRow({Name, std::to_string(BaseStopID + Stop)});
+                Stop = (Stop + 1 + Mix(Route, Index) % 3) % StopCount;
+            }
+        }
+        return Success;
+    }
+};
+
+CSyntheticMapGenerator::CSyntheticMapGenerator(std::size_t nodecount, uint64_t seed, std::size_t stopcount, std::size_t routecount) {
+    if (nodecount == 0) {
+        throw std::invalid_argument("nodecount must be positive");
+    }
+    DImplementation = std::make_unique<SImplementation>(nodecount, seed, stopcount, routecount);
+}
+
+CSyntheticMapGenerator::~CSyntheticMapGenerator() = default;
+
+std::size_t CSyntheticMapGenerator::NodeCount() const noexcept {
+    return DImplementation->NodeCount;
+}
+
+std::size_t CSyntheticMapGenerator::WayCount() const noexcept {
+    return DImplementation->WayCount;
+}
+
+std::size_t CSyntheticMapGenerator::StopCount() const noexcept {
+    return DImplementation->StopCount;
+}
+
+std::size_t CSyntheticMapGenerator::RouteCount() const noexcept {
+    return DImplementation->RouteCount;
+}
+
+CStreetMap::TNodeID CSyntheticMapGenerator::NodeID(std::size_t index) const noexcept {
+    if (index >= DImplementation->NodeCount) {
+        return CStreetMap::InvalidNodeID;
+    }
+    return DImplementation->NodeID(index);
+}
+
+bool CSyntheticMapGenerator::WriteOSM(std::shared_ptr<CDataSink> sink) const {
+    return sink && DImplementation->WriteOSM(sink);
+}
+
+bool CSyntheticMapGenerator::WriteStops(std::shared_ptr<CDataSink> sink) const {
+    return sink && DImplementation->WriteStops(sink);
+}
+
+bool CSyntheticMapGenerator::WriteRoutes(std::shared_ptr<CDataSink> sink) const {
+    return sink && DImplementation->WriteRoutes(sink);
+}
@@ -0,0 +1,256 @@
+#include "TransitGraph.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+struct CTransitGraph::SImplementation {
+    using TIndex = uint32_t;
+    static constexpr TIndex InvalidIndex = std::numeric_limits<TIndex>::max();
+    static constexpr double Unreached = std::numeric_limits<double>::infinity();
+
+    std::vector<CBusSystem::TStopID> StopIDs;
+    std::unordered_map<CBusSystem::TStopID, TIndex> StopIndices;
+
+    // route stop sequences in CSR layout, HopCosts[i] is the cost from RouteStops[i] to RouteStops[i + 1]
+    std::vector<std::string> RouteNames;
+    std::vector<TIndex> RouteOffsets;
+    std::vector<TIndex> RouteStops;
+    std::vector<double> HopCosts;
+
+    // (route, position) pairs serving each stop in CSR layout
+    std::vector<TIndex> StopRouteOffsets;
+    std::vector<std::pair<TIndex, TIndex>> StopRoutes;
+    std::vector<uint8_t> TransferStops;
+    std::size_t TransferStopCount = 0;
+
+    struct SParent {
+        TIndex DRoute = InvalidIndex; // InvalidIndex when the label was carried over from the previous round
+        TIndex DBoardPosition;
+        TIndex DAlightPosition;
+    };
+
+    TIndex StopIndex(CBusSystem::TStopID id) {
+        auto Search = StopIndices.find(id);
+        if (Search != StopIndices.end()) {
+            return Search->second;
+        }
+        TIndex Index = TIndex(StopIDs.size());
+        StopIndices[id] = Index;
+        StopIDs.push_back(id);
+        return Index;
+    }
+
+    SImplementation(const CBusSystem &bussystem, const CStopDistanceMatrix *distances) {
+        for (std::size_t Index = 0; Index < bussystem.StopCount(); Index++) {
+            StopIndex(bussystem.StopHandleByIndex(Index)->ID());
+        }
+        RouteOffsets.push_back(0);
+        for (std::size_t Index = 0; Index < bussystem.RouteCount(); Index++) {
+            auto Route = bussystem.RouteHandleByIndex(Index);
+            RouteNames.push_back(Route->Name());
+            for (std::size_t Position = 0; Position < Route->StopCount(); Position++) {
+                RouteStops.push_back(StopIndex(Route->GetStopID(Position)));
+            }
+            for (std::size_t Position = 0; Position < Route->StopCount(); Position++) {
+                double Cost = 1.0;
+                if (distances && Position + 1 < Route->StopCount()) {
+                    Cost = distances->DistanceByID(Route->GetStopID(Position), Route->GetStopID(Position + 1));
+                }
+                HopCosts.push_back(Cost);
+            }
+            RouteOffsets.push_back(TIndex(RouteStops.size()));
+        }
+
+        StopRouteOffsets.assign(StopIDs.size() + 1, 0);
+        for (auto Stop : RouteStops) {
+            StopRouteOffsets[Stop + 1]++;
+        }
+        for (std::size_t Index = 0; Index < StopIDs.size(); Index++) {
+            StopRouteOffsets[Index + 1] += StopRouteOffsets[Index];
+        }
+        StopRoutes.resize(RouteStops.size());
+        std::vector<TIndex> Fill(StopRouteOffsets.begin(), StopRouteOffsets.end() - 1);
+        std::vector<TIndex> LastRoute(StopIDs.size(), InvalidIndex);
+        std::vector<TIndex> RoutesServing(StopIDs.size(), 0);
+        for (TIndex Route = 0; Route + 1 < RouteOffsets.size(); Route++) {
+            for (TIndex Position = 0; Position < RouteOffsets[Route + 1] - RouteOffsets[Route]; Position++) {
+                TIndex Stop = RouteStops[RouteOffsets[Route] + Position];
+                StopRoutes[Fill[Stop]++] = std::make_pair(Route, Position);
+                if (LastRoute[Stop] != Route) {
+                    LastRoute[Stop] = Route;
+                    RoutesServing[Stop]++;
+                }
+            }
+        }
+        TransferStops.assign(StopIDs.size(), 0);
+        for (std::size_t Index = 0; Index < StopIDs.size(); Index++) {
+            if (RoutesServing[Index] > 1) {
+                TransferStops[Index] = 1;
+                TransferStopCount++;
+            }
+        }
+    }
+
+    // round based search, round k holds the best arrival at each stop using at most k rides
+    bool FindJourneys(CBusSystem::TStopID src, CBusSystem::TStopID dest, std::vector<SJourney> &journeys, std::size_t maxtransfers) const {
+        journeys.clear();
+        auto SourceSearch = StopIndices.find(src);
+        auto DestinationSearch = StopIndices.find(dest);
+        if (SourceSearch == StopIndices.end() || DestinationSearch == StopIndices.end()) {
+            return false;
+        }
+        TIndex Source = SourceSearch->second;
+        TIndex Destination = DestinationSearch->second;
+        if (Source == Destination) {
+            journeys.push_back(SJourney{0.0, {}});
+            return true;
+        }
+
+        std::size_t Stops = StopIDs.size();
+        std::size_t Rounds = maxtransfers + 1;
+        std::size_t Words = (Stops + 63) / 64;
+        std::vector<double> Arrivals((Rounds + 1) * Stops, Unreached);
+        std::vector<SParent> Parents((Rounds + 1) * Stops);
+        std::vector<double> Best(Stops, Unreached);
+        std::vector<uint64_t> Marked(Words, 0);
+        std::vector<TIndex> RouteStart(RouteNames.size(), InvalidIndex);
+        std::vector<TIndex> QueuedRoutes;
+
+        Arrivals[Source] = 0.0;
+        Best[Source] = 0.0;
+        Marked[Source / 64] |= uint64_t(1) << (Source % 64);
+
+        for (std::size_t Round = 1; Round <= Rounds; Round++) {
+            const double *Previous = Arrivals.data() + (Round - 1) * Stops;
+            double *Current = Arrivals.data() + Round * Stops;
+            SParent *CurrentParents = Parents.data() + Round * Stops;
+            std::copy(Previous, Previous + Stops, Current);
+
+            // queue every route through a marked stop from its earliest marked position
+            QueuedRoutes.clear();
+            for (std::size_t Word = 0; Word < Words; Word++) {
+                uint64_t Bits = Marked[Word];
+                Marked[Word] = 0;
+                while (Bits) {
+                    TIndex Stop = TIndex(Word * 64 + __builtin_ctzll(Bits));
+                    Bits &= Bits - 1;
+                    for (TIndex Entry = StopRouteOffsets[Stop]; Entry < StopRouteOffsets[Stop + 1]; Entry++) {
+                        auto &RoutePosition = StopRoutes[Entry];
+                        if (RouteStart[RoutePosition.first] == InvalidIndex) {
+                            QueuedRoutes.push_back(RoutePosition.first);
+                            RouteStart[RoutePosition.first] = RoutePosition.second;
+                        } else if (RoutePosition.second < RouteStart[RoutePosition.first]) {
+                            RouteStart[RoutePosition.first] = RoutePosition.second;
+                        }
+                    }
+                }
+            }
+            if (QueuedRoutes.empty()) {
+                break;
+            }
+
+            for (auto Route : QueuedRoutes) {
+                TIndex Offset = RouteOffsets[Route];
+                TIndex Length = RouteOffsets[Route + 1] - Offset;
+                bool Boarded = false;
+                TIndex BoardPosition = 0;
+                double Riding = Unreached;
+                for (TIndex Position = RouteStart[Route]; Position < Length; Position++) {
+                    TIndex Stop = RouteStops[Offset + Position];
+                    if (Boarded) {
+                        Riding += HopCosts[Offset + Position - 1];
+                        if (Riding == Unreached) {
+                            Boarded = false; // no street path to this stop, the ride ends here
+                        } else if (Riding < std::min(Best[Stop], Best[Destination])) {
+                            Current[Stop] = Riding;
+                            Best[Stop] = Riding;
+                            CurrentParents[Stop] = SParent{Route, BoardPosition, Position};
+                            Marked[Stop / 64] |= uint64_t(1) << (Stop % 64);
+                        }
+                    }
+                    // board here if we reached the stop in the previous round before this ride would
+                    if (Previous[Stop] < Unreached && (!Boarded || Previous[Stop] < Riding)) {
+                        Boarded = true;
+                        BoardPosition = Position;
+                        Riding = Previous[Stop];
+                    }
+                }
+                RouteStart[Route] = InvalidIndex;
+            }
+
+            if (Current[Destination] < Previous[Destination]) {
+                journeys.push_back(Reconstruct(Parents, Round, Destination));
+                journeys.back().DArrival = Current[Destination];
+            }
+        }
+        return !journeys.empty();
+    }
+
+    SJourney Reconstruct(const std::vector<SParent> &parents, std::size_t round, TIndex stop) const {
+        SJourney Journey;
+        std::size_t Stops = StopIDs.size();
+        while (round > 0) {
+            const SParent &Parent = parents[round * Stops + stop];
+            if (Parent.DRoute != InvalidIndex) {
+                TIndex Offset = RouteOffsets[Parent.DRoute];
+                TIndex Board = RouteStops[Offset + Parent.DBoardPosition];
+                Journey.DLegs.push_back(SJourneyLeg{RouteNames[Parent.DRoute], StopIDs[Board], StopIDs[stop], Parent.DAlightPosition - Parent.DBoardPosition});
+                stop = Board;
+            }
+            round--;
+        }
+        std::reverse(Journey.DLegs.begin(), Journey.DLegs.end());
+        return Journey;
+    }
+};
+
+CTransitGraph::CTransitGraph(std::shared_ptr<CBusSystem> bussystem, std::shared_ptr<CStopDistanceMatrix> distances) {
+    if (!bussystem) {
+        throw std::invalid_argument("bussystem must not be null");
+    }
+    DImplementation = std::make_unique<SImplementation>(*bussystem, distances.get());
+}
+
+CTransitGraph::~CTransitGraph() = default;
+
+std::size_t CTransitGraph::StopCount() const noexcept {
+    return DImplementation->StopIDs.size();
+}
+
+std::size_t CTransitGraph::RouteCount() const noexcept {
+    return DImplementation->RouteNames.size();
+}
+
+std::size_t CTransitGraph::TransferStopCount() const noexcept {
+    return DImplementation->TransferStopCount;
+}
+
+bool CTransitGraph::IsTransferStop(CBusSystem::TStopID id) const noexcept {
+    auto Search = DImplementation->StopIndices.find(id);
+    if (Search == DImplementation->StopIndices.end()) {
+        return false;
+    }
+    return DImplementation->TransferStops[Search->second];
+}
+
+bool CTransitGraph::FindJourneys(CBusSystem::TStopID src, CBusSystem::TStopID dest, std::vector<SJourney> &journeys, std::size_t maxtransfers) const {
+    return DImplementation->FindJourneys(src, dest, journeys, maxtransfers);
+}
+
+bool CTransitGraph::FindMinimumTransfers(CBusSystem::TStopID src, CBusSystem::TStopID dest, SJourney &journey, std::size_t maxtransfers) const {
+    std::vector<SJourney> Journeys;
+    if (!DImplementation->FindJourneys(src, dest, Journeys, maxtransfers)) {
+        return false;
+    }
+    journey = Journeys.front();
+    return true;
+}
+
+bool CTransitGraph::FindEarliestArrival(CBusSystem::TStopID src, CBusSystem::TStopID dest, SJourney &journey, std::size_t maxtransfers) const {
+    std::vector<SJourney> Journeys;
+    if (!DImplementation->FindJourneys(src, dest, Journeys, maxtransfers)) {
+        return false;
+    }
+    journey = Journeys.back();
+    return true;
+}
@@ -10,9 +10,16 @@ struct CXMLReader::SImplementation {
     std::queue<SXMLEntity> queue;
     std::string chardata;
     bool dataend;
+    SLoadStats *stats = nullptr;
+    std::size_t opendepth = 0; // elements whose start has been returned but not their end
+    std::size_t skipdepth = 0; // while nonzero the handlers only count nesting, nothing is built
 
     static void handlestart(void *data, const char *name, const char ** attributes) {
         auto * impl = static_cast<SImplementation *>(data);
+        if (impl->skipdepth) {
+            impl->skipdepth++;
+            return;
+        }
 
         if (!impl->chardata.empty()) {
             SXMLEntity ent; 
@@ -37,6 +44,10 @@ struct CXMLReader::SImplementation {
 
     static void handleend(void * data, const char * name) {
         auto *impl = static_cast<SImplementation *>(data);
+        if (impl->skipdepth) {
+            impl->skipdepth--; // the skipped element's own end is dropped too
+            return;
+        }
 
         if (!impl->chardata.empty()) {
             SXMLEntity ent; 
@@ -54,7 +65,7 @@ struct CXMLReader::SImplementation {
 
     static void handlechar(void * data, const char * s, int length) {
         auto * impl = static_cast<SImplementation *>(data);
-        if (s && length > 0) {
+        if (s && length > 0 && !impl->skipdepth) {
             impl->chardata.append(s, length);
         }
     }
@@ -71,53 +82,80 @@ struct CXMLReader::SImplementation {
     }
 
 
-    bool ReadEntity(SXMLEntity &entity, bool skipCharData = false) {
+    // reads the next block from the source into the parser, false at the end of the data or on an error
+    bool Feed() {
         std::vector<char> buffer(4096);
-
-        if (!queue.empty()) {
-            entity = queue.front();
-            queue.pop();
-
-            if (skipCharData && entity.DType == SXMLEntity::EType::CharData) {
-                return ReadEntity(entity, skipCharData);
+        size_t bytes = 0;
+        CLoadPhaseTimer IOTimer(stats ? &stats->DIOSeconds : nullptr);
+
+        while (bytes < buffer.size() && !source->End()) {
+            char c;
+            if (source->Get(c)) {
+                buffer[bytes++] = c;
+            } else {
+                break;
             }
-
-            return true;
+        }
+        IOTimer.Stop();
+        if (bytes == 0) {
+            dataend = true; 
+            return false;
         }
 
-        while (!dataend && queue.empty()) {
-            size_t bytes = 0;
-
-            while (bytes < buffer.size() && !source->End()) {
-                char c;
-                if (source->Get(c)) {
-                    buffer[bytes++] = c;
-                } else {
-                    break;
-                }
-            }
-            if (bytes == 0) {
-                dataend = true; 
-                return false;
-            }
+        CLoadPhaseTimer TokenizeTimer(stats ? &stats->DTokenizeSeconds : nullptr);
+        if (stats) {
+            stats->DBytesRead += bytes;
+        }
+        return XML_Parse(parser, buffer.data(), bytes, bytes == 0) != XML_STATUS_ERROR;
+    }
 
-            if (XML_Parse(parser, buffer.data(), bytes, bytes == 0) == XML_STATUS_ERROR) {
+    bool ReadEntity(SXMLEntity &entity, bool skipCharData = false) {
+        while (queue.empty()) {
+            if (dataend || !Feed()) {
                 return false;
             }
+        }
+        entity = queue.front();
+        queue.pop();
 
-            if (!queue.empty()) {
-                entity = queue.front();
-                queue.pop();
+        if (skipCharData && entity.DType == SXMLEntity::EType::CharData) {
+            return ReadEntity(entity, skipCharData);
+        }
+        if (entity.DType == SXMLEntity::EType::StartElement) {
+            opendepth++;
+        } else if (entity.DType == SXMLEntity::EType::EndElement && opendepth) {
+            opendepth--;
+        }
+        return true;
+    }
 
-                if (skipCharData && entity.DType == SXMLEntity::EType::CharData) {
-                    return ReadEntity(entity, skipCharData);
-                }
+    bool SkipElement() {
+        if (!opendepth) {
+            return false;
+        }
+        // entities already parsed are dropped first, counting nesting until the open element closes
+        std::size_t depth = 1;
+        while (!queue.empty()) {
+            SXMLEntity::EType type = queue.front().DType;
+            queue.pop();
+            if (type == SXMLEntity::EType::StartElement) {
+                depth++;
+            } else if (type == SXMLEntity::EType::EndElement && --depth == 0) {
+                opendepth--;
                 return true;
             }
-
         }
-        
-        return false;
+        // then the parser runs with the handlers building nothing, text pending so far is inside the element
+        chardata.clear();
+        skipdepth = depth;
+        while (skipdepth) {
+            if (dataend || !Feed()) {
+                skipdepth = 0;
+                return false;
+            }
+        }
+        opendepth--;
+        return true;
     }
 
 };
@@ -135,3 +173,11 @@ bool CXMLReader::End() const {
 bool CXMLReader::ReadEntity(SXMLEntity& entity, bool skipCharData) {
     return DImplementation->ReadEntity(entity, skipCharData);
 }
+
+void CXMLReader::SetStats(SLoadStats *stats) noexcept {
+    DImplementation->stats = stats;
+}
+
+bool CXMLReader::SkipElement() {
+    return DImplementation->SkipElement();
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "CSVBusSystem.h"
+#include "StringDataSource.h"
+
+static std::shared_ptr<CCSVBusSystem> CreateBusSystem(){
+    auto StopSource = std::make_shared<CStringDataSource>("1,100\n2,200\n3,200\n4,400\n");
+    auto RouteSource = std::make_shared<CStringDataSource>("A,1\nA,2\nA,1\nB,2\nB,3\nB,9\n");
+    return std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(StopSource, ','), std::make_shared<CDSVReader>(RouteSource, ','));
+}
+
+TEST(CSVBusSystem, StopRouteTest){
+    auto BusSystem = CreateBusSystem();
+
+    EXPECT_EQ(BusSystem->StopRouteCount(1), 1);
+    EXPECT_EQ(BusSystem->StopRouteByIndex(1, 0)->Name(), "A");
+    EXPECT_EQ(BusSystem->StopRouteByIndex(1, 1), nullptr);
+    ASSERT_EQ(BusSystem->StopRouteCount(2), 2);
+    EXPECT_NE(BusSystem->StopRouteByIndex(2, 0)->Name(), BusSystem->StopRouteByIndex(2, 1)->Name());
+    EXPECT_EQ(BusSystem->StopRouteCount(3), 1);
+    EXPECT_EQ(BusSystem->StopRouteByIndex(3, 0)->Name(), "B");
+    EXPECT_EQ(BusSystem->StopRouteCount(4), 0);
+    EXPECT_EQ(BusSystem->StopRouteCount(9), 0);
+    EXPECT_EQ(BusSystem->StopRouteByIndex(9, 0), nullptr);
+}
+
+TEST(CSVBusSystem, NodeStopTest){
+    auto BusSystem = CreateBusSystem();
+
+    EXPECT_EQ(BusSystem->NodeStopCount(100), 1);
+    EXPECT_EQ(BusSystem->NodeStopByIndex(100, 0)->ID(), 1);
+    ASSERT_EQ(BusSystem->NodeStopCount(200), 2);
+    EXPECT_EQ(BusSystem->NodeStopByIndex(200, 0)->ID(), 2);
+    EXPECT_EQ(BusSystem->NodeStopByIndex(200, 1)->ID(), 3);
+    EXPECT_EQ(BusSystem->NodeStopByIndex(200, 2), nullptr);
+    EXPECT_EQ(BusSystem->NodeStopCount(300), 0);
+    EXPECT_EQ(BusSystem->NodeStopByIndex(300, 0), nullptr);
+}
+
+TEST(CSVBusSystem, LoadStatsTest){
+    std::string Stops = "1,100\n2,200\n3,200\n4,400\n";
+    std::string Routes = "A,1\nA,2\nA,1\nB,2\nB,3\nB,9\n";
+    SLoadStats Stats;
+    CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Stops), ','),
+                            std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Routes), ','), &Stats);
+
+    EXPECT_EQ(Stats.DBytesRead, Stops.size() + Routes.size());
+    EXPECT_EQ(Stats.DStopCount, 4);
+    EXPECT_EQ(Stats.DRouteCount, 2);
+    EXPECT_EQ(Stats.DNodeCount, 0);
+    EXPECT_EQ(Stats.DIOSeconds, 0.0);
+    EXPECT_GT(Stats.DTokenizeSeconds, 0.0);
+    EXPECT_GT(Stats.DIndexSeconds, 0.0);
+    EXPECT_EQ(Stats.DAllocationCount, 0);
+#if defined(__unix__) || defined(__APPLE__)
+    EXPECT_GT(Stats.DPeakResidentBytes, 0);
+#endif
+}
+
+TEST(CSVBusSystem, HandleTest){
+    auto BusSystem = CreateBusSystem();
+
+    EXPECT_EQ(BusSystem->StopHandleByIndex(1), BusSystem->StopByIndex(1).get());
+    EXPECT_EQ(BusSystem->StopHandleByID(3), BusSystem->StopByID(3).get());
+    EXPECT_EQ(BusSystem->StopHandleByID(3)->NodeID(), 200);
+    EXPECT_EQ(BusSystem->StopHandleByIndex(4), nullptr);
+    EXPECT_EQ(BusSystem->StopHandleByID(9), nullptr);
+    EXPECT_EQ(BusSystem->RouteHandleByName("B"), BusSystem->RouteByName("B").get());
+    EXPECT_EQ(BusSystem->RouteHandleByName("B")->StopCount(), 3);
+    EXPECT_EQ(BusSystem->RouteHandleByIndex(0), BusSystem->RouteByIndex(0).get());
+    EXPECT_EQ(BusSystem->RouteHandleByIndex(2), nullptr);
+    EXPECT_EQ(BusSystem->RouteHandleByName("C"), nullptr);
+    EXPECT_EQ(BusSystem->StopRouteHandleByIndex(3, 0)->Name(), "B");
+    EXPECT_EQ(BusSystem->StopRouteHandleByIndex(3, 1), nullptr);
+    EXPECT_EQ(BusSystem->NodeStopHandleByIndex(200, 1)->ID(), 3);
+    EXPECT_EQ(BusSystem->NodeStopHandleByIndex(300, 0), nullptr);
+}
+
+TEST(CSVBusSystem, RepeatedStopTest){
+    auto StopSource = std::make_shared<CStringDataSource>("1,100\n2,200\n1,300\n");
+    auto RouteSource = std::make_shared<CStringDataSource>("A,1\n");
+    CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(StopSource, ','), std::make_shared<CDSVReader>(RouteSource, ','));
+
+    // both rows are kept, lookups by id find the first
+    ASSERT_EQ(BusSystem.StopCount(), 3);
+    EXPECT_EQ(BusSystem.StopByID(1), BusSystem.StopByIndex(0));
+    EXPECT_EQ(BusSystem.StopHandleByID(1), BusSystem.StopByID(1).get());
+    EXPECT_EQ(BusSystem.StopByID(1)->NodeID(), 100);
+    EXPECT_EQ(BusSystem.StopByID(5), nullptr);
+}
+
+TEST(CSVBusSystem, BatchLookupTest){
+    auto BusSystem = CreateBusSystem();
+    CBusSystem::TStopID IDs[] = {4, 9, 1};
+    std::size_t Indices[3];
+    const CBusSystem::SStop *Stops[3];
+
+    BusSystem->StopIndicesByID(IDs, 3, Indices);
+    EXPECT_EQ(Indices[0], 3);
+    EXPECT_EQ(Indices[1], BusSystem->StopCount());
+    EXPECT_EQ(Indices[2], 0);
+    BusSystem->StopHandlesByID(IDs, 3, Stops);
+    EXPECT_EQ(Stops[0], BusSystem->StopHandleByID(4));
+    EXPECT_EQ(Stops[1], nullptr);
+    EXPECT_EQ(Stops[2]->NodeID(), 100);
+}
+
+TEST(CSVBusSystem, ParseErrorTest){
+    auto StopSource = std::make_shared<CStringDataSource>("stop_id,node_id\n1,100\n2,x\n3,300\n");
+    auto RouteSource = std::make_shared<CStringDataSource>("route,stop_id\nA,1\nA,\nA,3\n");
+    CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(StopSource, ','), std::make_shared<CDSVReader>(RouteSource, ','));
+
+    EXPECT_EQ(BusSystem.StopCount(), 2);
+    EXPECT_EQ(BusSystem.StopByIndex(1)->ID(), 3);
+    ASSERT_NE(BusSystem.RouteByName("A"), nullptr);
+    EXPECT_EQ(BusSystem.RouteByName("A")->StopCount(), 2);
+    EXPECT_EQ(BusSystem.ParseErrors().DInvalid, 1);
+    EXPECT_EQ(BusSystem.ParseErrors().DEmpty, 1);
+}
+
+TEST(CSVBusSystem, HeaderColumnsTest){
+    auto StopSource = std::make_shared<CStringDataSource>("name,node_id,stop_id\nFirst,100,1\nSecond,200,2\n");
+    auto RouteSource = std::make_shared<CStringDataSource>("stop_id,route\n1,A\n2,A\n");
+    CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(StopSource, ','), std::make_shared<CDSVReader>(RouteSource, ','));
+
+    ASSERT_EQ(BusSystem.StopCount(), 2);
+    EXPECT_EQ(BusSystem.StopByIndex(0)->ID(), 1);
+    EXPECT_EQ(BusSystem.StopByIndex(0)->NodeID(), 100);
+    EXPECT_EQ(BusSystem.StopByIndex(1)->NodeID(), 200);
+    ASSERT_NE(BusSystem.RouteByName("A"), nullptr);
+    EXPECT_EQ(BusSystem.RouteByName("A")->GetStopID(1), 2);
+    EXPECT_EQ(BusSystem.ParseErrors().Total(), 0);
+}
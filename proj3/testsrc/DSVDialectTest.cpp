@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "DSVDialect.h"
+#include "DSVReader.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+TEST(DSVDialect, MatchesRuntimeReaderTest){
+    std::string Data = "a,\"b,c\",\"d\"\"e\"\n\n\"multi\nline\",f\ng";
+    CDSVReader Runtime(std::make_shared<CStringDataSource>(Data), ',');
+    CDSVDialectReader<SCSVDialect> Dialect(std::make_shared<CStringDataSource>(Data));
+    std::vector< std::string > RuntimeRow, DialectRow;
+
+    while(Runtime.ReadRow(RuntimeRow)){
+        ASSERT_TRUE(Dialect.ReadRow(DialectRow));
+        EXPECT_EQ(DialectRow, RuntimeRow);
+    }
+    EXPECT_FALSE(Dialect.ReadRow(DialectRow));
+    EXPECT_TRUE(Dialect.End());
+}
+
+TEST(DSVDialect, ReaderTest){
+    CDSVDialectReader<SExcelCSVDialect> Excel(std::make_shared<CStringDataSource>("a,b\r\n\"c\r\n\",d\re\nf\r\n"));
+    std::vector< std::string > Row;
+
+    ASSERT_TRUE(Excel.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"a", "b"}));
+    ASSERT_TRUE(Excel.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"c\r\n", "d\re"}));
+    ASSERT_TRUE(Excel.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"f"}));
+    EXPECT_FALSE(Excel.ReadRow(Row));
+
+    CDSVDialectReader<STSVDialect> TSV(std::make_shared<CStringDataSource>("say \"hi\"\tb\n\"x\t\"y\n"));
+    ASSERT_TRUE(TSV.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"say \"hi\"", "b"}));
+    ASSERT_TRUE(TSV.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"\"x", "\"y"}));
+
+    CDSVDialectReader< SDSVDialect<'|', '\''> > Pipe(std::make_shared<CStringDataSource>("'a|b'|'it''s'|\"c\"\n"));
+    ASSERT_TRUE(Pipe.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"a|b", "it's", "\"c\""}));
+}
+
+TEST(DSVDialect, WriterTest){
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVDialectWriter<SExcelCSVDialect> Excel(Sink);
+    EXPECT_TRUE(Excel.WriteRow({"a", "b,c", "say \"hi\"", "two\nlines"}));
+    EXPECT_TRUE(Excel.WriteRow({}));
+    EXPECT_EQ(Sink->String(), "a,\"b,c\",\"say \"\"hi\"\"\",\"two\nlines\"\r\n\r\n");
+
+    auto TSVSink = std::make_shared<CStringDataSink>();
+    CDSVDialectWriter<STSVDialect> TSV(TSVSink, true);
+    EXPECT_TRUE(TSV.WriteRow({"a", "say \"hi\""}));
+    EXPECT_FALSE(TSV.WriteRow({"ok", "tab\there"}));
+    EXPECT_EQ(TSVSink->String(), "a\tsay \"hi\"\n");
+
+    auto QuotedSink = std::make_shared<CStringDataSink>();
+    CDSVDialectWriter<SCSVDialect> Quoted(QuotedSink, true);
+    EXPECT_TRUE(Quoted.WriteRow({"a", ""}));
+    EXPECT_EQ(QuotedSink->String(), "\"a\",\"\"\n");
+}
+
+TEST(DSVDialect, RoundTripTest){
+    std::vector< std::vector< std::string > > Rows = {{"plain", "with,comma"}, {"\"quoted\"", "cr\r\nlf"}, {"", "last"}};
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVDialectWriter<SExcelCSVDialect> Writer(Sink);
+    for(auto &Row : Rows){
+        ASSERT_TRUE(Writer.WriteRow(Row));
+    }
+    CDSVDialectReader<SExcelCSVDialect> Reader(std::make_shared<CStringDataSource>(Sink->String()));
+    std::vector< std::string > Row;
+    for(auto &Expected : Rows){
+        ASSERT_TRUE(Reader.ReadRow(Row));
+        EXPECT_EQ(Row, Expected);
+    }
+    EXPECT_FALSE(Reader.ReadRow(Row));
+}
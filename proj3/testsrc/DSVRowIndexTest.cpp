@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "DSVRowIndex.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+// row 2 holds a quoted newline and row 5 is empty, the last row has no newline
+static const std::string RowData = "r0,a\nr1,b\nr2,\"multi\nline\"\nr3,\"say \"\"hi\"\"\"\nr4,e\n\nr6,g";
+
+TEST(DSVRowIndex, BuildTest){
+    CStringDataSource Source(RowData);
+    CDSVRowIndex Index(2);
+    std::size_t Row, Offset;
+
+    ASSERT_TRUE(Index.Build(Source));
+    EXPECT_EQ(Index.RowCount(), 7);
+    ASSERT_TRUE(Index.Checkpoint(3, Row, Offset));
+    EXPECT_EQ(Row, 2);
+    EXPECT_EQ(Offset, 10);
+    ASSERT_TRUE(Index.Checkpoint(6, Row, Offset));
+    EXPECT_EQ(Row, 6);
+    EXPECT_EQ(Offset, RowData.size() - 4);
+    EXPECT_TRUE(Index.Checkpoint(7, Row, Offset));
+    EXPECT_FALSE(Index.Checkpoint(8, Row, Offset));
+}
+
+TEST(DSVRowIndex, SeekRowTest){
+    auto Source = std::make_shared<CStringDataSource>(RowData);
+    auto Index = std::make_shared<CDSVRowIndex>(2);
+    ASSERT_TRUE(Index->Build(*Source));
+    CIndexedDSVReader Reader(Source, ',', Index);
+    std::vector< std::string > Row;
+
+    ASSERT_TRUE(Reader.SeekRow(3));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"r3", "say \"hi\""}));
+    EXPECT_EQ(Reader.Row(), 4);
+    ASSERT_TRUE(Reader.SeekRow(2));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"r2", "multi\nline"}));
+    ASSERT_TRUE(Reader.SeekRow(5));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({""}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"r6", "g"}));
+    EXPECT_FALSE(Reader.ReadRow(Row));
+    EXPECT_TRUE(Reader.End());
+    ASSERT_TRUE(Reader.SeekRow(7));
+    EXPECT_FALSE(Reader.ReadRow(Row));
+    EXPECT_FALSE(Reader.SeekRow(8));
+    ASSERT_TRUE(Reader.SeekRow(0));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row[0], "r0");
+}
+
+TEST(DSVRowIndex, SidecarTest){
+    CStringDataSource Source(RowData);
+    CDSVRowIndex Index(3);
+    ASSERT_TRUE(Index.Build(Source));
+    auto Sink = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(Index.Save(Sink));
+
+    CDSVRowIndex Loaded;
+    ASSERT_TRUE(Loaded.Load(std::make_shared<CStringDataSource>(Sink->String()), Source));
+    EXPECT_EQ(Loaded.Interval(), 3);
+    EXPECT_EQ(Loaded.RowCount(), 7);
+    std::size_t Row, Offset, LoadedRow, LoadedOffset;
+    for(std::size_t Query = 0; Query <= 7; Query++){
+        ASSERT_TRUE(Index.Checkpoint(Query, Row, Offset));
+        ASSERT_TRUE(Loaded.Checkpoint(Query, LoadedRow, LoadedOffset));
+        EXPECT_EQ(LoadedRow, Row);
+        EXPECT_EQ(LoadedOffset, Offset);
+    }
+
+    // a sidecar for a source that has since changed size or content, or a damaged one, is refused
+    CDSVRowIndex Stale;
+    CStringDataSource Grown(RowData + "\nr7,h");
+    EXPECT_FALSE(Stale.Load(std::make_shared<CStringDataSource>(Sink->String()), Grown));
+    std::string Edited = RowData;
+    Edited[Edited.size() - 2] ^= 1;
+    CStringDataSource Rewritten(Edited);
+    EXPECT_FALSE(Stale.Load(std::make_shared<CStringDataSource>(Sink->String()), Rewritten));
+    EXPECT_FALSE(Stale.Load(std::make_shared<CStringDataSource>(Sink->String() + "2\n"), Source));
+    EXPECT_FALSE(Stale.Load(std::make_shared<CStringDataSource>("r0,a\n"), Source));
+    EXPECT_EQ(Stale.RowCount(), 0);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "DSVTable.h"
+#include "StringDataSource.h"
+
+static std::shared_ptr< CDSVReader > Reader(const std::string &data){
+    return std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(data), ',');
+}
+
+TEST(DSVTable, InferTest){
+    CDSVTable Table(Reader("id,lat,name,empty\n1,38.5,A St,\n-2,39,B St,\n3,,A St,\n4,40.25\n"));
+
+    ASSERT_EQ(Table.RowCount(), 4);
+    ASSERT_EQ(Table.ColumnCount(), 4);
+    EXPECT_EQ(Table.ColumnIndex("name"), 2);
+    EXPECT_EQ(Table.ColumnIndex("missing"), 4);
+    EXPECT_EQ(Table.ColumnName(1), "lat");
+    EXPECT_TRUE(Table.ColumnType(0) == CDSVTable::EType::Int64);
+    EXPECT_TRUE(Table.ColumnType(1) == CDSVTable::EType::Double);
+    EXPECT_TRUE(Table.ColumnType(2) == CDSVTable::EType::String);
+    EXPECT_TRUE(Table.ColumnType(3) == CDSVTable::EType::String);
+
+    ASSERT_NE(Table.Int64Column(0), nullptr);
+    EXPECT_EQ(Table.Int64Column(0)[1], -2);
+    EXPECT_EQ(Table.DoubleColumn(0), nullptr);
+    ASSERT_NE(Table.DoubleColumn(1), nullptr);
+    EXPECT_EQ(Table.DoubleColumn(1)[1], 39.0);
+    EXPECT_EQ(Table.DoubleColumn(1)[3], 40.25);
+    EXPECT_EQ(Table.NullCount(1), 1);
+    EXPECT_EQ(Table.ValidColumn(1)[2], 0);
+    EXPECT_EQ(Table.DoubleColumn(1)[2], 0.0);
+
+    // the short last row leaves name null
+    EXPECT_EQ(Table.DictionarySize(2), 2);
+    EXPECT_EQ(Table.StringCodes(2)[0], Table.StringCodes(2)[2]);
+    EXPECT_EQ(Table.DictionaryValue(2, Table.StringCodes(2)[1]), "B St");
+    EXPECT_EQ(Table.NullCount(2), 1);
+    EXPECT_EQ(Table.NullCount(3), 4);
+    EXPECT_EQ(Table.ParseErrors().Total(), 0);
+}
+
+TEST(DSVTable, SampleTest){
+    // the sample of 2 rows says int64, the later decimal does not decode and becomes a counted null
+    CDSVTable Table(Reader("1,x\n2,y\n3.5,z\n"), false, 2);
+
+    ASSERT_EQ(Table.RowCount(), 3);
+    EXPECT_EQ(Table.ColumnName(0), "0");
+    EXPECT_TRUE(Table.ColumnType(0) == CDSVTable::EType::Int64);
+    EXPECT_EQ(Table.ValidColumn(0)[2], 0);
+    EXPECT_EQ(Table.ParseErrors().DInvalid, 1);
+    EXPECT_EQ(Table.DictionaryValue(1, Table.StringCodes(1)[2]), "z");
+}
+
+TEST(DSVTable, SchemaTest){
+    std::vector< CDSVTable::SColumnSchema > Schema = {{"node_id", CDSVTable::EType::Int64}, {"stop_id", CDSVTable::EType::String}, {"route", CDSVTable::EType::String}};
+    CDSVTable Table(Reader("stop_id,node_id\n22043,2849810514\n22358,2849805223\n"), Schema);
+
+    ASSERT_EQ(Table.RowCount(), 2);
+    ASSERT_EQ(Table.ColumnCount(), 3);
+    EXPECT_EQ(Table.Int64Column(0)[1], 2849805223);
+    EXPECT_EQ(Table.DictionaryValue(1, Table.StringCodes(1)[0]), "22043");
+    EXPECT_EQ(Table.NullCount(2), 2);
+
+    CDSVTable Empty(Reader(""));
+    EXPECT_EQ(Empty.RowCount(), 0);
+    EXPECT_EQ(Empty.ColumnCount(), 0);
+    EXPECT_EQ(Empty.ColumnName(0), "");
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "DSVReader.h"
+#include "StringDataSource.h"
+
+TEST(DSVReader, ReadRowTest){
+    CDSVReader Reader(std::make_shared<CStringDataSource>("a,\"b,c\",\"d\"\"e\"\n\nf"), ',');
+    std::vector< std::string > Row;
+
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"a", "b,c", "d\"e"}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({""}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"f"}));
+    EXPECT_FALSE(Reader.ReadRow(Row));
+    EXPECT_TRUE(Reader.End());
+}
+
+TEST(DSVReader, ReadHeaderTest){
+    CDSVReader Reader(std::make_shared<CStringDataSource>("id,name,\"x,y\",node\n1,\"One, first\",skip,10\n2,Two\n\n3,Three,skip,30,extra"), ',');
+    std::vector< std::string > Row;
+
+    ASSERT_TRUE(Reader.ReadHeader({"node", "id"}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"10", "1"}));
+    // short rows leave the missing columns empty
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"", "2"}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"", ""}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"30", "3"}));
+    EXPECT_FALSE(Reader.ReadRow(Row));
+}
+
+TEST(DSVReader, SelectColumnsTest){
+    CDSVReader Reader(std::make_shared<CStringDataSource>("a,b,c\n1,2,3\n4,5,6\n"), ',');
+    std::vector< std::string > Header;
+
+    ASSERT_TRUE(Reader.ReadRow(Header));
+    EXPECT_FALSE(Reader.SelectColumns(Header, {"a", "d"}));
+    EXPECT_FALSE(Reader.SelectColumns(Header, {"a", "a"}));
+    EXPECT_FALSE(Reader.SelectColumns(Header, {}));
+    std::vector< std::string > Row;
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"1", "2", "3"}));
+    ASSERT_TRUE(Reader.SelectColumns(Header, {"c"}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector< std::string >({"6"}));
+    EXPECT_FALSE(Reader.ReadHeader({"a"}));
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "FileDataSink.h"
+#include <fstream>
+#include <sstream>
+
+static std::string ReadBack(const std::string &filename){
+    std::ifstream Input(filename, std::ios::binary);
+    std::stringstream Buffer;
+    Buffer << Input.rdbuf();
+    return Buffer.str();
+}
+
+TEST(FileDataSink, PutWriteTest){
+    std::string Filename = ::testing::TempDir() + "FileDataSinkTest.txt";
+    {
+        CFileDataSink Sink(Filename);
+        std::vector<char> TempVector = {'l','l','o'};
+
+        ASSERT_TRUE(Sink.IsOpen());
+        EXPECT_TRUE(Sink.Put('H'));
+        EXPECT_TRUE(Sink.Put('e'));
+        EXPECT_TRUE(Sink.Write(TempVector));
+        EXPECT_TRUE(Sink.Flush());
+        EXPECT_EQ(ReadBack(Filename),"Hello");
+        EXPECT_TRUE(Sink.Put('!'));
+    }
+    EXPECT_EQ(ReadBack(Filename),"Hello!");
+    std::remove(Filename.c_str());
+}
+
+TEST(FileDataSink, BadPathTest){
+    CFileDataSink Sink("/nonexistent-directory/out.txt");
+
+    EXPECT_FALSE(Sink.IsOpen());
+    EXPECT_FALSE(Sink.Put('H'));
+    EXPECT_FALSE(Sink.Write({'H'}));
+    EXPECT_FALSE(Sink.Flush());
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "FileDataSource.h"
+#include <fstream>
+
+TEST(FileDataSource, GetPeekReadTest){
+    std::string Filename = ::testing::TempDir() + "FileDataSourceTest.txt";
+    {
+        std::ofstream Output(Filename, std::ios::binary);
+        Output << "Hello World";
+    }
+    CFileDataSource Source(Filename);
+    std::vector<char> TempVector;
+    char TempChar;
+
+    ASSERT_TRUE(Source.IsOpen());
+    EXPECT_FALSE(Source.End());
+    EXPECT_TRUE(Source.Peek(TempChar));
+    EXPECT_EQ(TempChar, 'H');
+    EXPECT_TRUE(Source.Get(TempChar));
+    EXPECT_EQ(TempChar, 'H');
+    EXPECT_TRUE(Source.Read(TempVector, 5));
+    EXPECT_EQ(std::string(TempVector.begin(), TempVector.end()), "ello ");
+    EXPECT_TRUE(Source.Read(TempVector, 10));
+    EXPECT_EQ(std::string(TempVector.begin(), TempVector.end()), "World");
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Get(TempChar));
+    EXPECT_FALSE(Source.Peek(TempChar));
+    EXPECT_FALSE(Source.Read(TempVector, 1));
+
+    EXPECT_EQ(Source.Size(), 11);
+    EXPECT_EQ(Source.Tell(), 11);
+    EXPECT_TRUE(Source.Seek(6));
+    EXPECT_FALSE(Source.End());
+    EXPECT_TRUE(Source.Get(TempChar));
+    EXPECT_EQ(TempChar, 'W');
+    EXPECT_EQ(Source.Tell(), 7);
+    EXPECT_FALSE(Source.Seek(12));
+    std::remove(Filename.c_str());
+}
+
+TEST(FileDataSource, BadPathTest){
+    CFileDataSource Source("/nonexistent-directory/in.txt");
+    std::vector<char> TempVector;
+    char TempChar;
+
+    EXPECT_FALSE(Source.IsOpen());
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Get(TempChar));
+    EXPECT_FALSE(Source.Read(TempVector, 1));
+}
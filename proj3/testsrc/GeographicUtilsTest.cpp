@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "GeographicUtils.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr double Pi = 3.14159265358979323846;
+
+TEST(GeographicUtils, FixedLocationTest){
+    SFixedLocation Fixed = GeographicUtils::ToFixed({38.5513421, -121.7394657});
+
+    EXPECT_EQ(sizeof(SFixedLocation) * 2, sizeof(CStreetMap::TLocation));
+    EXPECT_EQ(Fixed.DLatitude, 385513421);
+    EXPECT_EQ(Fixed.DLongitude, -1217394657);
+    EXPECT_NEAR(GeographicUtils::FromFixed(Fixed).first, 38.5513421, 1e-9);
+    EXPECT_NEAR(GeographicUtils::FromFixed(Fixed).second, -121.7394657, 1e-9);
+    // the nearest unit, also for values a double cannot hold exactly
+    EXPECT_EQ(GeographicUtils::ToFixed({0.00000005, -0.00000015}).DLatitude, 1);
+    EXPECT_EQ(GeographicUtils::ToFixed({0.00000005, -0.00000015}).DLongitude, -2);
+    EXPECT_TRUE(GeographicUtils::ToFixed({-90.0, 180.0}) == (SFixedLocation{-900000000, 1800000000}));
+}
+
+TEST(GeographicUtils, DistanceTest){
+    double Degree = GeographicUtils::EarthRadiusMeters * Pi / 180.0;
+
+    EXPECT_NEAR(GeographicUtils::HaversineDistance({38.5, -121.7}, {39.5, -121.7}), Degree, 1e-6);
+    EXPECT_NEAR(GeographicUtils::HaversineDistance({0.0, 0.0}, {0.0, 180.0}), Degree * 180.0, 1e-6);
+    EXPECT_EQ(GeographicUtils::HaversineDistance({38.5, -121.7}, {38.5, -121.7}), 0.0);
+    EXPECT_NEAR(GeographicUtils::HaversineDistance({38.5, -121.700}, {38.5, -121.701}), 87.0, 0.5);
+    // the approximation holds across a town
+    double Exact = GeographicUtils::HaversineDistance({38.53, -121.78}, {38.57, -121.70});
+    EXPECT_NEAR(GeographicUtils::EquirectangularDistance({38.53, -121.78}, {38.57, -121.70}), Exact, Exact * 1e-3);
+}
+
+TEST(GeographicUtils, BearingTest){
+    EXPECT_NEAR(GeographicUtils::Bearing({38.5, -121.7}, {39.5, -121.7}), 0.0, 1e-9);
+    EXPECT_NEAR(GeographicUtils::Bearing({0.0, 0.0}, {0.0, 1.0}), 90.0, 1e-9);
+    EXPECT_NEAR(GeographicUtils::Bearing({38.5, -121.7}, {37.5, -121.7}), 180.0, 1e-9);
+    EXPECT_NEAR(GeographicUtils::Bearing({0.0, 0.0}, {0.0, -1.0}), 270.0, 1e-9);
+    EXPECT_NEAR(GeographicUtils::Bearing({0.0, 0.0}, {1.0, 1.0}), 45.0, 0.01);
+}
+
+TEST(GeographicUtils, BatchTest){
+    // long enough to cross a block and end on an odd point
+    std::vector< CStreetMap::TLocation > Points;
+    std::vector< SFixedLocation > FixedPoints;
+    for(int Index = 0; Index < 131; Index++){
+        Points.emplace_back(38.5 + Index * 0.001, -121.7 - Index * 0.0017);
+        FixedPoints.push_back(GeographicUtils::ToFixed(Points.back()));
+    }
+    CStreetMap::TLocation Origin(38.55, -121.75);
+    std::vector< double > Results(Points.size()), FixedResults(Points.size());
+
+    GeographicUtils::HaversineDistances(Origin, Points.data(), Points.size(), Results.data());
+    GeographicUtils::HaversineDistances(Origin, FixedPoints.data(), FixedPoints.size(), FixedResults.data());
+    for(std::size_t Index = 0; Index < Points.size(); Index++){
+        EXPECT_NEAR(Results[Index], GeographicUtils::HaversineDistance(Origin, Points[Index]), 1e-6);
+        EXPECT_NEAR(FixedResults[Index], Results[Index], 1e-6);
+    }
+    GeographicUtils::EquirectangularDistances(Origin, Points.data(), Points.size(), Results.data());
+    GeographicUtils::EquirectangularDistances(Origin, FixedPoints.data(), FixedPoints.size(), FixedResults.data());
+    for(std::size_t Index = 0; Index < Points.size(); Index++){
+        EXPECT_NEAR(Results[Index], GeographicUtils::EquirectangularDistance(Origin, Points[Index]), 1e-6);
+        EXPECT_NEAR(FixedResults[Index], Results[Index], 1e-6);
+    }
+    GeographicUtils::Bearings(Origin, Points.data(), Points.size(), Results.data());
+    GeographicUtils::Bearings(Origin, FixedPoints.data(), FixedPoints.size(), FixedResults.data());
+    for(std::size_t Index = 0; Index < Points.size(); Index++){
+        EXPECT_NEAR(Results[Index], GeographicUtils::Bearing(Origin, Points[Index]), 1e-9);
+        EXPECT_NEAR(FixedResults[Index], Results[Index], 1e-9);
+    }
+}
+
+TEST(GeographicUtils, PairBatchTest){
+    std::vector< SFixedLocation > Locations = {
+        GeographicUtils::ToFixed({38.5, -121.7}),
+        GeographicUtils::ToFixed({38.5, -121.701}),
+        GeographicUtils::ToFixed({0.0, 179.5}),
+        GeographicUtils::ToFixed({0.0, -179.5})
+    };
+    std::vector< uint32_t > Sources = {0, 1, 2, 0};
+    std::vector< uint32_t > Targets = {1, 0, 3, 0};
+    std::vector< double > Results(Sources.size());
+
+    GeographicUtils::HaversineDistances(Locations.data(), Locations.size(), Sources.data(), Targets.data(), Sources.size(), Results.data());
+    for(std::size_t Index = 0; Index < Sources.size(); Index++){
+        EXPECT_NEAR(Results[Index], GeographicUtils::HaversineDistance(GeographicUtils::FromFixed(Locations[Sources[Index]]), GeographicUtils::FromFixed(Locations[Targets[Index]])), 1e-6);
+    }
+    // across the antimeridian the short way round
+    EXPECT_NEAR(Results[2], GeographicUtils::EarthRadiusMeters * Pi / 180.0, 1e-6);
+    EXPECT_EQ(Results[3], 0.0);
+}
+
+TEST(GeographicUtils, HilbertIndexTest){
+    EXPECT_EQ(GeographicUtils::HilbertIndex({INT32_MIN, INT32_MIN}), 0);
+    // an aligned 4 x 4 cell block is one run of the curve, each step moving to a neighbouring cell
+    std::vector< std::pair< uint64_t, SFixedLocation > > Cells;
+    for(int32_t Latitude = 385000000; Latitude < 385000004; Latitude++){
+        for(int32_t Longitude = -1217000000; Longitude < -1216999996; Longitude++){
+            SFixedLocation Location{Latitude, Longitude};
+            Cells.emplace_back(GeographicUtils::HilbertIndex(Location), Location);
+        }
+    }
+    std::sort(Cells.begin(), Cells.end(), [](const auto &first, const auto &second){
+        return first.first < second.first;
+    });
+    for(std::size_t Index = 1; Index < Cells.size(); Index++){
+        EXPECT_EQ(Cells[Index].first, Cells[0].first + Index);
+        int32_t Steps = std::abs(Cells[Index].second.DLatitude - Cells[Index - 1].second.DLatitude)
+            + std::abs(Cells[Index].second.DLongitude - Cells[Index - 1].second.DLongitude);
+        EXPECT_EQ(Steps, 1);
+    }
+}
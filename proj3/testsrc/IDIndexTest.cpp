@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "IDIndex.h"
+
+TEST(IDIndex, EmptyTest){
+    CIDIndex Index;
+    uint64_t IDs[] = {1, 2};
+    std::size_t Positions[2];
+
+    EXPECT_EQ(Index.Size(), 0);
+    EXPECT_EQ(Index.Find(1), CIDIndex::NotFound);
+    Index.Find(IDs, 2, Positions);
+    EXPECT_EQ(Positions[0], CIDIndex::NotFound);
+    EXPECT_EQ(Positions[1], CIDIndex::NotFound);
+    Index.Build(IDs, 0);
+    EXPECT_EQ(Index.Find(1), CIDIndex::NotFound);
+}
+
+TEST(IDIndex, FindTest){
+    CIDIndex Index;
+    uint64_t IDs[] = {30, 10, 20, 10, 0, 18446744073709551615ULL};
+    Index.Build(IDs, 6);
+
+    EXPECT_EQ(Index.Size(), 5);
+    EXPECT_EQ(Index.Find(30), 0);
+    EXPECT_EQ(Index.Find(10), 1);
+    EXPECT_EQ(Index.Find(20), 2);
+    EXPECT_EQ(Index.Find(0), 4);
+    EXPECT_EQ(Index.Find(18446744073709551615ULL), 5);
+    EXPECT_EQ(Index.Find(40), CIDIndex::NotFound);
+    // both lookup methods agree on the first position of a repeated id
+    uint64_t Queries[] = {10, 20};
+    std::size_t Probed[2], Merged[2];
+    Index.FindProbed(Queries, 2, Probed);
+    Index.FindMerged(Queries, 2, Merged);
+    EXPECT_EQ(Probed[0], 1);
+    EXPECT_EQ(Merged[0], 1);
+    EXPECT_EQ(Merged[1], 2);
+}
+
+TEST(IDIndex, BatchTest){
+    // collisions galore, every id shares its low bits
+    std::vector<uint64_t> IDs;
+    for(uint64_t ID = 0; ID < 20000; ID++){
+        IDs.push_back(ID << 32);
+    }
+    CIDIndex Index;
+    Index.Build(IDs.data(), IDs.size());
+
+    std::vector<uint64_t> Queries;
+    for(std::size_t Query = 0; Query < 10000; Query++){
+        Queries.push_back(Query % 3 ? IDs[(Query * 7919) % IDs.size()] : (Query << 32) + 1);
+    }
+    std::vector<std::size_t> Probed(Queries.size()), Merged(Queries.size()), Chosen(Queries.size());
+    Index.FindProbed(Queries.data(), Queries.size(), Probed.data());
+    Index.FindMerged(Queries.data(), Queries.size(), Merged.data());
+    Index.Find(Queries.data(), Queries.size(), Chosen.data());
+    for(std::size_t Query = 0; Query < Queries.size(); Query++){
+        EXPECT_EQ(Probed[Query], Index.Find(Queries[Query]));
+        EXPECT_EQ(Merged[Query], Probed[Query]);
+        EXPECT_EQ(Chosen[Query], Probed[Query]);
+        EXPECT_EQ(Probed[Query], Query % 3 ? (Query * 7919) % IDs.size() : CIDIndex::NotFound);
+    }
+}
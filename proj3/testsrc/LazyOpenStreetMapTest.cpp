@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include "LazyOpenStreetMap.h"
+#include "OpenStreetMap.h"
+#include "SyntheticMapGenerator.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+static const std::string MapData = "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<!-- <node id=\"99\"/> is commented out -->\n"
+    "<osm version=\"0.6\">\n"
+    "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>\n"
+    "\t<node id=\"2\" lat='38.6' lon=\"-121.8\" note=\"a > b\">\n"
+    "\t\t<tag k=\"highway\" v=\"traffic_signals\"/>\n"
+    "\t</node>\n"
+    "\t<node id=\"3\" lat=\"38.7\" lon=\"-121.9\"/>\n"
+    "\t<way id=\"10\">\n"
+    "\t\t<nd ref=\"1\"/>\n"
+    "\t\t<nd ref=\"2\"/>\n"
+    "\t\t<tag k=\"name\" v=\"A Street\"/>\n"
+    "\t</way>\n"
+    "</osm>\n";
+
+TEST(LazyOpenStreetMap, LoadTest){
+    CLazyOpenStreetMap StreetMap(std::make_shared<CStringDataSource>(MapData));
+
+    ASSERT_EQ(StreetMap.NodeCount(), 3);
+    ASSERT_EQ(StreetMap.WayCount(), 1);
+    EXPECT_EQ(StreetMap.CachedCount(), 0);
+    EXPECT_EQ(StreetMap.NodeLocation(1), std::make_pair(38.6, -121.8));
+    auto Node = StreetMap.NodeByID(2);
+    ASSERT_NE(Node, nullptr);
+    EXPECT_EQ(Node->ID(), 2);
+    EXPECT_EQ(Node->Location(), std::make_pair(38.6, -121.8));
+    EXPECT_EQ(Node->GetAttribute("highway"), "traffic_signals");
+    EXPECT_EQ(Node->GetAttribute("note"), "a > b");
+    EXPECT_EQ(StreetMap.CachedCount(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(1), Node);
+    EXPECT_EQ(StreetMap.CachedCount(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->AttributeCount(), 0);
+    auto Way = StreetMap.WayByID(10);
+    ASSERT_NE(Way, nullptr);
+    EXPECT_EQ(Way->NodeCount(), 2);
+    EXPECT_EQ(Way->GetNodeID(1), 2);
+    EXPECT_EQ(Way->GetAttribute("name"), "A Street");
+    EXPECT_EQ(StreetMap.NodeByID(99), nullptr);
+    EXPECT_EQ(StreetMap.NodeByIndex(3), nullptr);
+    EXPECT_EQ(StreetMap.WayByID(11), nullptr);
+}
+
+TEST(LazyOpenStreetMap, CacheTest){
+    CLazyOpenStreetMap StreetMap(std::make_shared<CStringDataSource>(MapData), 2);
+
+    auto First = StreetMap.NodeByIndex(0);
+    StreetMap.NodeByIndex(1);
+    StreetMap.NodeByIndex(2);
+    EXPECT_EQ(StreetMap.CachedCount(), 2);
+    // evicted objects stay valid for their holders and are decoded again on the next access
+    EXPECT_EQ(First->ID(), 1);
+    auto Again = StreetMap.NodeByIndex(0);
+    EXPECT_NE(Again, First);
+    EXPECT_EQ(Again->ID(), 1);
+    EXPECT_EQ(StreetMap.CachedCount(), 2);
+}
+
+TEST(LazyOpenStreetMap, MatchesEagerTest){
+    auto Sink = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(CSyntheticMapGenerator(3000, 9).WriteOSM(Sink));
+    COpenStreetMap Eager(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Sink->String())));
+    CLazyOpenStreetMap Lazy(std::make_shared<CStringDataSource>(Sink->String()), 64);
+
+    ASSERT_EQ(Lazy.NodeCount(), Eager.NodeCount());
+    ASSERT_EQ(Lazy.WayCount(), Eager.WayCount());
+    for(std::size_t Index = 0; Index < Eager.NodeCount(); Index += 7){
+        auto Expected = Eager.NodeByIndex(Index);
+        auto Actual = Lazy.NodeByID(Expected->ID());
+        ASSERT_NE(Actual, nullptr);
+        EXPECT_EQ(Actual->Location(), Expected->Location());
+        EXPECT_EQ(Lazy.NodeLocation(Index), Expected->Location());
+        EXPECT_EQ(Actual->AttributeCount(), Expected->AttributeCount());
+    }
+    for(std::size_t Index = 0; Index < Eager.WayCount(); Index++){
+        auto Expected = Eager.WayByIndex(Index);
+        auto Actual = Lazy.WayByIndex(Index);
+        ASSERT_EQ(Actual->ID(), Expected->ID());
+        ASSERT_EQ(Actual->NodeCount(), Expected->NodeCount());
+        EXPECT_EQ(Actual->GetNodeID(Actual->NodeCount() - 1), Expected->GetNodeID(Expected->NodeCount() - 1));
+        EXPECT_EQ(Actual->GetAttribute("name"), Expected->GetAttribute("name"));
+    }
+    EXPECT_LE(Lazy.CachedCount(), 64);
+}
+
+TEST(LazyOpenStreetMap, HandleTest){
+    CLazyOpenStreetMap StreetMap(std::make_shared<CStringDataSource>(MapData), 1);
+
+    auto Node = StreetMap.NodeHandleByID(2);
+    ASSERT_NE(Node, nullptr);
+    EXPECT_EQ(Node->GetAttribute("highway"), "traffic_signals");
+    // handles are pinned, so walking the rest of the map through the small cache leaves them valid
+    for(std::size_t Index = 0; Index < StreetMap.NodeCount(); Index++){
+        StreetMap.NodeByIndex(Index);
+    }
+    StreetMap.WayByIndex(0);
+    EXPECT_EQ(StreetMap.NodeHandleByIndex(1), Node);
+    EXPECT_EQ(StreetMap.NodeByIndex(1).get(), Node);
+    EXPECT_EQ(Node->ID(), 2);
+    EXPECT_EQ(StreetMap.WayHandleByID(10)->GetNodeID(0), 1);
+    EXPECT_EQ(StreetMap.NodeHandleByIndex(3), nullptr);
+    EXPECT_EQ(StreetMap.WayHandleByID(11), nullptr);
+}
+
+TEST(LazyOpenStreetMap, HandleScopeTest){
+    CLazyOpenStreetMap StreetMap(std::make_shared<CStringDataSource>(MapData), 1);
+
+    auto Kept = StreetMap.NodeHandleByID(1);
+    ASSERT_NE(Kept, nullptr);
+    EXPECT_EQ(StreetMap.PinnedCount(), 1);
+    {
+        CLazyOpenStreetMap::CHandleScope Scope(StreetMap);
+        for(std::size_t Index = 0; Index < StreetMap.NodeCount(); Index++){
+            ASSERT_NE(StreetMap.NodeHandleByIndex(Index), nullptr);
+        }
+        // an element already pinned by the map is not pinned again
+        EXPECT_EQ(StreetMap.NodeHandleByIndex(0), Kept);
+        EXPECT_EQ(Scope.PinnedCount(), 2);
+        {
+            CLazyOpenStreetMap::CHandleScope Inner(StreetMap);
+            ASSERT_NE(StreetMap.WayHandleByIndex(0), nullptr);
+            EXPECT_EQ(Inner.PinnedCount(), 1);
+        }
+        EXPECT_EQ(Scope.PinnedCount(), 2);
+        EXPECT_EQ(StreetMap.PinnedCount(), 1);
+        // shared_ptr access does not pin
+        StreetMap.WayByIndex(0);
+        EXPECT_EQ(Scope.PinnedCount(), 2);
+    }
+    EXPECT_EQ(StreetMap.PinnedCount(), 1);
+    EXPECT_EQ(StreetMap.CachedCount(), 1);
+    EXPECT_EQ(Kept->ID(), 1);
+    EXPECT_EQ(StreetMap.NodeHandleByIndex(0), Kept);
+}
+
+TEST(LazyOpenStreetMap, DecodeMatchesEagerTest){
+    std::string Data = "<?xml version='1.0' encoding='UTF-8'?>\r\n"
+        "<osm version=\"0.6\">\r\n"
+        "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.7\" user=\"A &amp; B\">\r\n"
+        "\t\t<!-- <tag k=\"skipped\" v=\"yes\"/> -->\r\n"
+        "\t\t<tag k=\"name\" v=\"Smith &amp; Sons &lt;&#233;&#x263A;&gt; &quot;q&quot; &apos;a&apos;\"/>\r\n"
+        "\t\t<tag k='note' v='tab\there\r\nnext &#10;line'/>\r\n"
+        "\t\t<tag k=\"user\" v=\"override\"/>\r\n"
+        "\t\t<tag k=\"\" v=\"empty key\"/>\r\n"
+        "\t</node>\r\n"
+        "\t<node id=\"2\" lat=\"38.6\" lon=\"-121.8\"/>\r\n"
+        "\t<way id=\"10\" lat=\"1\">\r\n"
+        "\t\t<nd ref=\"1\"/><nd ref=\"x\"/><nd ref=\"2\"/>\r\n"
+        "\t\t<tag k=\"name\" v=\"A&#32;Street\"/>\r\n"
+        "\t</way>\r\n"
+        "</osm>\r\n";
+    COpenStreetMap Eager(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)));
+    CLazyOpenStreetMap Lazy(std::make_shared<CStringDataSource>(Data));
+
+    ASSERT_EQ(Lazy.NodeCount(), Eager.NodeCount());
+    for(std::size_t Index = 0; Index < Eager.NodeCount(); Index++){
+        auto Expected = Eager.NodeByIndex(Index);
+        auto Actual = Lazy.NodeByIndex(Index);
+        ASSERT_NE(Actual, nullptr);
+        EXPECT_EQ(Actual->ID(), Expected->ID());
+        EXPECT_EQ(Actual->Location(), Expected->Location());
+        ASSERT_EQ(Actual->AttributeCount(), Expected->AttributeCount());
+        for(std::size_t Attribute = 0; Attribute < Expected->AttributeCount(); Attribute++){
+            std::string Key = Expected->GetAttributeKey(Attribute);
+            EXPECT_EQ(Actual->GetAttributeKey(Attribute), Key);
+            EXPECT_EQ(Actual->GetAttribute(Key), Expected->GetAttribute(Key));
+        }
+    }
+    EXPECT_EQ(Lazy.NodeByID(1)->GetAttribute("note"), "tab here next \nline");
+    auto Expected = Eager.WayByIndex(0);
+    auto Actual = Lazy.WayByIndex(0);
+    ASSERT_NE(Actual, nullptr);
+    ASSERT_EQ(Actual->NodeCount(), Expected->NodeCount());
+    EXPECT_EQ(Actual->GetNodeID(1), Expected->GetNodeID(1));
+    EXPECT_EQ(Actual->GetAttribute("lat"), Expected->GetAttribute("lat"));
+    EXPECT_EQ(Actual->GetAttribute("name"), "A Street");
+}
+
+TEST(LazyOpenStreetMap, InvalidElementTest){
+    std::string Data = "<osm>\n"
+        "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>\n"
+        "\t<node id=\"x2\" lat=\"38.6\" lon=\"-121.8\"/>\n"
+        "\t<node id=\"3\" lat=\"north\" lon=\"-121.9\"><tag k=\"name\" v=\"dropped\"/></node>\n"
+        "\t<node id=\"4\" lat=\"38.7\" lon=\"-122.0\"/>\n"
+        "\t<way id=\"\"><nd ref=\"1\"/></way>\n"
+        "\t<way id=\"10\" lat=\"north\"><nd ref=\"1\"/><nd ref=\"4\"/></way>\n"
+        "</osm>\n";
+    COpenStreetMap Eager(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)));
+    CLazyOpenStreetMap Lazy(std::make_shared<CStringDataSource>(Data));
+
+    // elements whose id or location does not decode are dropped by both maps
+    ASSERT_EQ(Lazy.NodeCount(), Eager.NodeCount());
+    ASSERT_EQ(Lazy.WayCount(), Eager.WayCount());
+    EXPECT_EQ(Lazy.NodeCount(), 2);
+    EXPECT_EQ(Lazy.WayCount(), 1);
+    EXPECT_EQ(Lazy.NodeByIndex(1)->ID(), 4);
+    EXPECT_EQ(Lazy.NodeByID(3), nullptr);
+    EXPECT_EQ(Lazy.WayByIndex(0)->ID(), 10);
+    EXPECT_EQ(Lazy.WayByIndex(0)->NodeCount(), 2);
+}
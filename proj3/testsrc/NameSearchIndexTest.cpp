@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "NameSearchIndex.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "StringDataSource.h"
+
+TEST(NameSearchIndex, SearchTest){
+    CNameSearchIndex Index;
+    Index.AddName("Russell Boulevard", CNameSearchIndex::EType::Way, 1);
+    Index.AddName("russell boulevard", CNameSearchIndex::EType::Way, 2);
+    Index.AddName("Russell Park", CNameSearchIndex::EType::Node, 3);
+    Index.AddName("Anderson Road", CNameSearchIndex::EType::Way, 4);
+    Index.AddName("Sycamore Lane", CNameSearchIndex::EType::Way, 5);
+    Index.AddName("", CNameSearchIndex::EType::Way, 6);
+
+    EXPECT_EQ(Index.NameCount(), 4);
+    auto Matches = Index.Search("RUSEL BOULEVARD", 5);
+    ASSERT_EQ(Matches.size(), 1);
+    EXPECT_EQ(Matches[0].DName, "Russell Boulevard");
+    EXPECT_EQ(Matches[0].DDistance, 2);
+    ASSERT_EQ(Matches[0].DEntries.size(), 2);
+    EXPECT_EQ(Matches[0].DEntries[1].DID, 2);
+
+    Matches = Index.Search("anderson rd", 2, 20);
+    ASSERT_EQ(Matches.size(), 2);
+    EXPECT_EQ(Matches[0].DName, "Anderson Road");
+    EXPECT_EQ(Matches[0].DDistance, 2);
+    EXPECT_LE(Matches[0].DDistance, Matches[1].DDistance);
+
+    EXPECT_TRUE(Index.Search("zzzzzz", 3, 1).empty());
+    EXPECT_TRUE(Index.Search("anderson road", 0).empty());
+}
+
+TEST(NameSearchIndex, SourceTest){
+    auto MapSource = std::make_shared<CStringDataSource>(
+        "<osm>"
+        "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"><tag k=\"name\" v=\"Memorial Union\"/></node>"
+        "<node id=\"2\" lat=\"38.5\" lon=\"-121.7\"/>"
+        "<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><tag k=\"name\" v=\"Russell Boulevard\"/></way>"
+        "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(MapSource));
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("1,1\n"), ','),
+        std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("Q,1\n"), ','));
+    CNameSearchIndex Index(StreetMap, BusSystem);
+
+    EXPECT_EQ(Index.NameCount(), 3);
+    auto Matches = Index.Search("memorial onion", 1);
+    ASSERT_EQ(Matches.size(), 1);
+    EXPECT_TRUE(Matches[0].DEntries[0].DType == CNameSearchIndex::EType::Node);
+    EXPECT_EQ(Matches[0].DEntries[0].DID, 1);
+    Matches = Index.Search("russel blvd", 1, 8);
+    ASSERT_EQ(Matches.size(), 1);
+    EXPECT_TRUE(Matches[0].DEntries[0].DType == CNameSearchIndex::EType::Way);
+    Matches = Index.Search("q", 1, 0);
+    ASSERT_EQ(Matches.size(), 1);
+    EXPECT_TRUE(Matches[0].DEntries[0].DType == CNameSearchIndex::EType::Route);
+}
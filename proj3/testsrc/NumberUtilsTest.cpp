@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "NumberUtils.h"
+
+TEST(NumberUtils, ToUInt64Test){
+    uint64_t Value = 7;
+    SParseErrors Errors;
+
+    EXPECT_TRUE(NumberUtils::ToUInt64("2849810514", Value, &Errors));
+    EXPECT_EQ(Value, 2849810514ULL);
+    EXPECT_TRUE(NumberUtils::ToUInt64(" 12\r", Value, &Errors));
+    EXPECT_EQ(Value, 12);
+    EXPECT_TRUE(NumberUtils::ToUInt64("+3", Value, &Errors));
+    EXPECT_EQ(Value, 3);
+    EXPECT_TRUE(NumberUtils::ToUInt64("18446744073709551615", Value, &Errors));
+    EXPECT_EQ(Value, 18446744073709551615ULL);
+    EXPECT_EQ(Errors.Total(), 0);
+
+    Value = 7;
+    EXPECT_FALSE(NumberUtils::ToUInt64("", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToUInt64("  ", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToUInt64("stop_id", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToUInt64("12a", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToUInt64("-1", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToUInt64("+-1", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToUInt64("18446744073709551616", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToUInt64("x", Value));
+    EXPECT_EQ(Value, 7);
+    EXPECT_EQ(Errors.DEmpty, 2);
+    EXPECT_EQ(Errors.DInvalid, 4);
+    EXPECT_EQ(Errors.DOutOfRange, 1);
+}
+
+TEST(NumberUtils, ToInt64Test){
+    int64_t Value = 7;
+    SParseErrors Errors;
+
+    EXPECT_TRUE(NumberUtils::ToInt64("-42", Value, &Errors));
+    EXPECT_EQ(Value, -42);
+    EXPECT_TRUE(NumberUtils::ToInt64(" +42 ", Value, &Errors));
+    EXPECT_EQ(Value, 42);
+    EXPECT_FALSE(NumberUtils::ToInt64("9223372036854775808", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToInt64("4.2", Value, &Errors));
+    EXPECT_EQ(Value, 42);
+    EXPECT_EQ(Errors.DOutOfRange, 1);
+    EXPECT_EQ(Errors.DInvalid, 1);
+}
+
+TEST(NumberUtils, ToDoubleTest){
+    double Value = 0.5;
+    SParseErrors Errors;
+
+    EXPECT_TRUE(NumberUtils::ToDouble("38.5400783", Value, &Errors));
+    EXPECT_EQ(Value, 38.5400783);
+    EXPECT_TRUE(NumberUtils::ToDouble("-121.7", Value, &Errors));
+    EXPECT_EQ(Value, -121.7);
+    EXPECT_TRUE(NumberUtils::ToDouble("\t+1e3 ", Value, &Errors));
+    EXPECT_EQ(Value, 1000.0);
+    EXPECT_EQ(Errors.Total(), 0);
+
+    Value = 0.5;
+    EXPECT_FALSE(NumberUtils::ToDouble("", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToDouble("38,5", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToDouble("lat", Value, &Errors));
+    EXPECT_FALSE(NumberUtils::ToDouble("1e999", Value, &Errors));
+    EXPECT_EQ(Value, 0.5);
+    EXPECT_EQ(Errors.DEmpty, 1);
+    EXPECT_EQ(Errors.DInvalid, 2);
+    EXPECT_EQ(Errors.DOutOfRange, 1);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "OSMFilter.h"
+#include "OpenStreetMap.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+static const std::string MapData = "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<osm version=\"0.6\">\n"
+    "\t<bounds minlat=\"38.0\" minlon=\"-122.0\" maxlat=\"39.0\" maxlon=\"-121.0\"/>\n"
+    "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.5\"/>\n"
+    "\t<node id=\"2\" lat=\"38.6\" lon=\"-121.6\">\n"
+    "\t\t<tag k=\"highway\" v=\"traffic_signals\"/>\n"
+    "\t</node>\n"
+    "\t<node id=\"3\" lat=\"38.9\" lon=\"-121.9\"/>\n"
+    "\t<node id=\"4\" lat=\"38.1\" lon=\"-121.1\"/>\n"
+    "\t<way id=\"10\">\n"
+    "\t\t<nd ref=\"1\"/>\n"
+    "\t\t<nd ref=\"3\"/>\n"
+    "\t\t<tag k=\"highway\" v=\"residential\"/>\n"
+    "\t</way>\n"
+    "\t<way id=\"11\">\n"
+    "\t\t<nd ref=\"3\"/>\n"
+    "\t\t<nd ref=\"4\"/>\n"
+    "\t\t<tag k=\"highway\" v=\"primary\"/>\n"
+    "\t</way>\n"
+    "\t<way id=\"12\">\n"
+    "\t\t<nd ref=\"1\"/>\n"
+    "\t\t<nd ref=\"2\"/>\n"
+    "\t\t<tag k=\"building\" v=\"yes\"/>\n"
+    "\t</way>\n"
+    "\t<relation id=\"20\">\n"
+    "\t\t<member type=\"way\" ref=\"10\" role=\"\"/>\n"
+    "\t</relation>\n"
+    "</osm>\n";
+
+static std::shared_ptr<CXMLReader> CreateReader(const std::string &data){
+    return std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(data));
+}
+
+static COpenStreetMap FilterMap(COSMFilter &filter, bool closure){
+    auto Sink = std::make_shared<CStringDataSink>();
+    auto Writer = std::make_shared<CXMLWriter>(Sink);
+    bool Success = closure ? filter.Filter(CreateReader(MapData), CreateReader(MapData), Writer) : filter.Filter(CreateReader(MapData), Writer);
+    EXPECT_TRUE(Success);
+    return COpenStreetMap(CreateReader(Sink->String()));
+}
+
+TEST(OSMFilter, PassThroughTest){
+    COSMFilter Filter;
+    auto Sink = std::make_shared<CStringDataSink>();
+
+    ASSERT_TRUE(Filter.Filter(CreateReader(MapData), std::make_shared<CXMLWriter>(Sink)));
+    EXPECT_EQ(Filter.KeptNodeCount(), 4);
+    EXPECT_EQ(Filter.KeptWayCount(), 3);
+    std::string Prefix = "<osm version=\"0.6\">\n"
+        "\t<bounds minlat=\"38.0\" minlon=\"-122.0\" maxlat=\"39.0\" maxlon=\"-121.0\"/>\n"
+        "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.5\"/>\n";
+    EXPECT_EQ(Sink->String().substr(0, Prefix.size()), Prefix);
+    EXPECT_EQ(Sink->String().find("relation"), std::string::npos);
+    COpenStreetMap StreetMap(CreateReader(Sink->String()));
+    EXPECT_EQ(StreetMap.NodeCount(), 4);
+    EXPECT_EQ(StreetMap.WayCount(), 3);
+    EXPECT_EQ(StreetMap.NodeByID(2)->GetAttribute("highway"), "traffic_signals");
+}
+
+TEST(OSMFilter, TagTest){
+    COSMFilter Filter;
+    Filter.AddTagFilter(COSMFilter::EElement::Way, "highway");
+    Filter.AddTagFilter(COSMFilter::EElement::Node, "highway", "traffic_signals");
+    auto StreetMap = FilterMap(Filter, false);
+
+    ASSERT_EQ(StreetMap.NodeCount(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->ID(), 2);
+    ASSERT_EQ(StreetMap.WayCount(), 2);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->ID(), 10);
+    EXPECT_EQ(StreetMap.WayByIndex(1)->ID(), 11);
+
+    COSMFilter Primary;
+    Primary.AddTagFilter(COSMFilter::EElement::Way, "highway", "primary");
+    auto PrimaryMap = FilterMap(Primary, false);
+    ASSERT_EQ(PrimaryMap.WayCount(), 1);
+    EXPECT_EQ(PrimaryMap.WayByIndex(0)->ID(), 11);
+}
+
+TEST(OSMFilter, BoundingBoxTest){
+    COSMFilter Filter;
+    Filter.SetBoundingBox({38.4, -121.7}, {38.7, -121.4});
+    Filter.AddTagFilter(COSMFilter::EElement::Way, "highway");
+    auto StreetMap = FilterMap(Filter, false);
+
+    ASSERT_EQ(StreetMap.NodeCount(), 2);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->ID(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->ID(), 2);
+    // way 10 touches the box through node 1 but its node 3 lies outside and is dropped in one pass
+    ASSERT_EQ(StreetMap.WayCount(), 1);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->ID(), 10);
+    EXPECT_EQ(StreetMap.NodeByID(3), nullptr);
+}
+
+TEST(OSMFilter, ClosureTest){
+    COSMFilter Filter;
+    Filter.SetBoundingBox({38.4, -121.7}, {38.7, -121.4});
+    Filter.AddTagFilter(COSMFilter::EElement::Way, "highway");
+    auto StreetMap = FilterMap(Filter, true);
+
+    EXPECT_EQ(Filter.KeptNodeCount(), 3);
+    EXPECT_EQ(Filter.KeptWayCount(), 1);
+    ASSERT_EQ(StreetMap.NodeCount(), 3);
+    EXPECT_NE(StreetMap.NodeByID(3), nullptr);
+    EXPECT_EQ(StreetMap.NodeByID(4), nullptr);
+
+    Filter.SetReferencedNodesOnly(true);
+    auto ReferencedMap = FilterMap(Filter, true);
+    ASSERT_EQ(ReferencedMap.NodeCount(), 2);
+    EXPECT_EQ(ReferencedMap.NodeByIndex(0)->ID(), 1);
+    EXPECT_EQ(ReferencedMap.NodeByIndex(1)->ID(), 3);
+    EXPECT_EQ(ReferencedMap.WayCount(), 1);
+}
+
+TEST(OSMFilter, MalformedTest){
+    COSMFilter Filter;
+    auto Sink = std::make_shared<CStringDataSink>();
+
+    EXPECT_FALSE(Filter.Filter(CreateReader("<osm><node id=\"1\"></way></osm>"), std::make_shared<CXMLWriter>(Sink)));
+    EXPECT_FALSE(Filter.Filter(nullptr, std::make_shared<CXMLWriter>(Sink)));
+}
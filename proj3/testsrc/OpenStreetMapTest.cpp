@@ -0,0 +1,358 @@
+#include <gtest/gtest.h>
+#include "OpenStreetMap.h"
+#include "StringDataSource.h"
+#include "GeographicUtils.h"
+
+static const std::string MapData = "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<osm version=\"0.6\">\n"
+    "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>\n"
+    "\t<node id=\"2\" lat=\"38.6\" lon=\"-121.8\">\n"
+    "\t\t<tag k=\"highway\" v=\"traffic_signals\"/>\n"
+    "\t</node>\n"
+    "\t<node id=\"3\" lat=\"38.7\" lon=\"-121.9\"/>\n"
+    "\t<way id=\"10\">\n"
+    "\t\t<nd ref=\"1\"/>\n"
+    "\t\t<nd ref=\"2\"/>\n"
+    "\t\t<tag k=\"highway\" v=\"residential\"/>\n"
+    "\t\t<tag k=\"name\" v=\"A Street\"/>\n"
+    "\t</way>\n"
+    "</osm>\n";
+
+TEST(OpenStreetMap, LoadTest){
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(MapData)));
+
+    ASSERT_EQ(StreetMap.NodeCount(), 3);
+    ASSERT_EQ(StreetMap.WayCount(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->ID(), 2);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->Location(), std::make_pair(38.6, -121.8));
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->GetAttribute("highway"), "traffic_signals");
+    EXPECT_EQ(StreetMap.NodeByID(3)->ID(), 3);
+    EXPECT_EQ(StreetMap.NodeByID(4), nullptr);
+    EXPECT_EQ(StreetMap.WayByID(10)->NodeCount(), 2);
+    EXPECT_EQ(StreetMap.WayByID(10)->GetNodeID(1), 2);
+    EXPECT_EQ(StreetMap.WayByID(10)->GetAttribute("name"), "A Street");
+}
+
+TEST(OpenStreetMap, RepeatedIDTest){
+    std::string Data = "<osm>\n"
+        "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>\n"
+        "\t<node id=\"1\" lat=\"38.6\" lon=\"-121.8\"/>\n"
+        "\t<way id=\"10\"><nd ref=\"1\"/></way>\n"
+        "\t<way id=\"10\"><nd ref=\"1\"/><nd ref=\"1\"/></way>\n"
+        "</osm>\n";
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)));
+
+    // a repeated id finds the first element with it
+    ASSERT_EQ(StreetMap.NodeCount(), 2);
+    EXPECT_EQ(StreetMap.NodeByID(1), StreetMap.NodeByIndex(0));
+    EXPECT_EQ(StreetMap.NodeHandleByID(1), StreetMap.NodeHandleByIndex(0));
+    EXPECT_EQ(StreetMap.WayByID(10)->NodeCount(), 1);
+}
+
+TEST(OpenStreetMap, HandleTest){
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(MapData)));
+
+    EXPECT_EQ(StreetMap.NodeHandleByIndex(1), StreetMap.NodeByIndex(1).get());
+    EXPECT_EQ(StreetMap.NodeHandleByID(3), StreetMap.NodeByID(3).get());
+    EXPECT_EQ(StreetMap.NodeHandleByID(2)->GetAttribute("highway"), "traffic_signals");
+    EXPECT_EQ(StreetMap.NodeHandleByIndex(3), nullptr);
+    EXPECT_EQ(StreetMap.NodeHandleByID(4), nullptr);
+    EXPECT_EQ(StreetMap.WayHandleByIndex(0), StreetMap.WayByID(10).get());
+    EXPECT_EQ(StreetMap.WayHandleByID(10)->NodeCount(), 2);
+    EXPECT_EQ(StreetMap.WayHandleByIndex(1), nullptr);
+    EXPECT_EQ(StreetMap.WayHandleByID(11), nullptr);
+}
+
+TEST(OpenStreetMap, BatchLookupTest){
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(MapData)));
+    CStreetMap::TNodeID NodeIDs[] = {3, 4, 1, 3};
+    std::size_t Indices[4];
+    const CStreetMap::SNode *Nodes[4];
+    CStreetMap::TWayID WayIDs[] = {11, 10};
+    std::size_t WayIndices[2];
+    const CStreetMap::SWay *Ways[2];
+
+    StreetMap.NodeIndicesByID(NodeIDs, 4, Indices);
+    EXPECT_EQ(Indices[0], 2);
+    EXPECT_EQ(Indices[1], StreetMap.NodeCount());
+    EXPECT_EQ(Indices[2], 0);
+    EXPECT_EQ(Indices[3], 2);
+    StreetMap.NodeHandlesByID(NodeIDs, 4, Nodes);
+    EXPECT_EQ(Nodes[0], StreetMap.NodeHandleByID(3));
+    EXPECT_EQ(Nodes[1], nullptr);
+    EXPECT_EQ(Nodes[2], StreetMap.NodeHandleByID(1));
+    StreetMap.WayIndicesByID(WayIDs, 2, WayIndices);
+    EXPECT_EQ(WayIndices[0], StreetMap.WayCount());
+    EXPECT_EQ(WayIndices[1], 0);
+    StreetMap.WayHandlesByID(WayIDs, 2, Ways);
+    EXPECT_EQ(Ways[0], nullptr);
+    EXPECT_EQ(Ways[1], StreetMap.WayHandleByIndex(0));
+}
+
+TEST(OpenStreetMap, ResolveWayNodesTest){
+    std::string Data = "<osm>\n"
+        "\t<node id=\"5\" lat=\"1\" lon=\"1\"/>\n"
+        "\t<node id=\"6\" lat=\"2\" lon=\"2\"/>\n"
+        "\t<way id=\"1\"><nd ref=\"6\"/><nd ref=\"5\"/><nd ref=\"6\"/></way>\n"
+        "\t<way id=\"2\"/>\n"
+        "\t<way id=\"3\"><nd ref=\"7\"/><nd ref=\"5\"/></way>\n"
+        "</osm>\n";
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)));
+    std::vector< std::size_t > Offsets, Indices;
+
+    StreetMap.ResolveWayNodes(Offsets, Indices);
+    EXPECT_EQ(Offsets, std::vector< std::size_t >({0, 3, 3, 5}));
+    EXPECT_EQ(Indices, std::vector< std::size_t >({1, 0, 1, 2, 0}));
+}
+
+TEST(OpenStreetMap, ParseErrorTest){
+    std::string Data = "<osm>\n"
+        "\t<node id=\"1\" lat=\"1\" lon=\"1\"/>\n"
+        "\t<node id=\"two\" lat=\"2\" lon=\"2\"><tag k=\"name\" v=\"Two\"/></node>\n"
+        "\t<node id=\"3\" lat=\"3,5\" lon=\"3\"/>\n"
+        "\t<way id=\"10\"><nd ref=\"1\"/><nd ref=\"\"/><nd ref=\"3\"/></way>\n"
+        "</osm>\n";
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)));
+
+    ASSERT_EQ(StreetMap.NodeCount(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->ID(), 1);
+    ASSERT_EQ(StreetMap.WayCount(), 1);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->NodeCount(), 2);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->GetNodeID(1), 3);
+    EXPECT_EQ(StreetMap.ParseErrors().DInvalid, 2);
+    EXPECT_EQ(StreetMap.ParseErrors().DEmpty, 1);
+}
+
+TEST(OpenStreetMap, SkipRelationTest){
+    std::string Data = "<osm>\n"
+        "\t<node id=\"1\" lat=\"1\" lon=\"1\"/>\n"
+        "\t<relation id=\"20\">\n"
+        "\t\t<member type=\"node\" ref=\"1\" role=\"stop\"/>\n"
+        "\t\t<tag k=\"type\" v=\"route\"/>\n"
+        "\t</relation>\n"
+        "\t<node id=\"2\" lat=\"2\" lon=\"2\"><tag k=\"name\" v=\"Two\"/></node>\n"
+        "\t<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/></way>\n"
+        "</osm>\n";
+    SLoadStats Stats;
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Data)), &Stats);
+
+    ASSERT_EQ(StreetMap.NodeCount(), 2);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->GetAttribute("name"), "Two");
+    ASSERT_EQ(StreetMap.WayCount(), 1);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->NodeCount(), 2);
+    // the relation's tag is never built
+    EXPECT_EQ(Stats.DTagCount, 1);
+}
+
+TEST(OpenStreetMap, OutlivesMapTest){
+    std::shared_ptr<CStreetMap::SNode> Node;
+    std::shared_ptr<CStreetMap::SWay> Way;
+    {
+        COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(MapData)));
+        Node = StreetMap.NodeByID(2);
+        Way = StreetMap.WayByIndex(0);
+    }
+    // elements share the storage of the map, which is kept until the last of them goes
+    EXPECT_EQ(Node->Location(), std::make_pair(38.6, -121.8));
+    EXPECT_EQ(Node->GetAttributeKey(0), "highway");
+    EXPECT_EQ(Node->GetAttribute("highway"), "traffic_signals");
+    EXPECT_EQ(Way->GetNodeID(0), 1);
+    EXPECT_EQ(Way->GetAttribute("name"), "A Street");
+    EXPECT_EQ(Way->GetAttributeKey(2), "");
+}
+
+TEST(OpenStreetMap, LoadStatsTest){
+    SLoadStats Stats;
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(MapData)), &Stats);
+
+    EXPECT_EQ(Stats.DBytesRead, MapData.size());
+    EXPECT_EQ(Stats.DNodeCount, 3);
+    EXPECT_EQ(Stats.DWayCount, 1);
+    EXPECT_EQ(Stats.DTagCount, 3);
+    EXPECT_EQ(Stats.DStopCount, 0);
+    EXPECT_GT(Stats.DTokenizeSeconds, 0.0);
+    EXPECT_GE(Stats.DBuildSeconds, 0.0);
+    EXPECT_GT(Stats.TotalSeconds(), 0.0);
+    // the tests do not link the counting allocator
+    EXPECT_EQ(Stats.DAllocationCount, 0);
+#if defined(__unix__) || defined(__APPLE__)
+    EXPECT_GT(Stats.DPeakResidentBytes, 0);
+#endif
+}
+
+TEST(LoadStats, RecorderTest){
+    SLoadStats Stats;
+    CLoadStatsRecorder::CountAllocation(100);
+    {
+        CLoadStatsRecorder Recorder(&Stats);
+        CLoadStatsRecorder::CountAllocation(16);
+        {
+            // a recorder without stats leaves the outer one counting
+            CLoadStatsRecorder Inner(nullptr);
+            CLoadStatsRecorder::CountAllocation(8);
+        }
+    }
+    CLoadStatsRecorder::CountAllocation(100);
+    EXPECT_EQ(Stats.DAllocationCount, 2);
+    EXPECT_EQ(Stats.DAllocatedBytes, 24);
+}
+
+TEST(OpenStreetMap, LoadStatsDisabledTest){
+    SLoadStats Stats;
+    auto Reader = std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(MapData));
+    COpenStreetMap First(Reader, &Stats);
+    COpenStreetMap Second(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(MapData)));
+
+    // the second load was not given stats, so nothing it did is counted
+    EXPECT_EQ(Stats.DBytesRead, MapData.size());
+    EXPECT_EQ(Stats.DNodeCount, 3);
+}
+
+static const std::string FilterData = "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<osm version=\"0.6\">\n"
+    "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.5\" version=\"2\"/>\n"
+    "\t<node id=\"2\" lat=\"38.6\" lon=\"-121.6\">\n"
+    "\t\t<tag k=\"highway\" v=\"traffic_signals\"/>\n"
+    "\t\t<tag k=\"source\" v=\"survey\"/>\n"
+    "\t</node>\n"
+    "\t<node id=\"3\" lat=\"38.9\" lon=\"-121.9\"/>\n"
+    "\t<node id=\"4\" lat=\"38.1\" lon=\"-121.1\"/>\n"
+    "\t<way id=\"10\" version=\"3\">\n"
+    "\t\t<nd ref=\"1\"/>\n"
+    "\t\t<nd ref=\"3\"/>\n"
+    "\t\t<tag k=\"highway\" v=\"residential\"/>\n"
+    "\t\t<tag k=\"name\" v=\"A Street\"/>\n"
+    "\t</way>\n"
+    "\t<way id=\"11\">\n"
+    "\t\t<nd ref=\"3\"/>\n"
+    "\t\t<nd ref=\"4\"/>\n"
+    "\t\t<tag k=\"highway\" v=\"primary\"/>\n"
+    "\t</way>\n"
+    "\t<way id=\"12\">\n"
+    "\t\t<nd ref=\"1\"/>\n"
+    "\t\t<nd ref=\"2\"/>\n"
+    "\t\t<tag k=\"building\" v=\"yes\"/>\n"
+    "\t</way>\n"
+    "</osm>\n";
+
+static bool IsHighway(const std::vector< COpenStreetMap::SLoadOptions::TTag > &tags){
+    for(auto &Tag : tags){
+        if(Tag.first == "highway"){
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST(OpenStreetMap, LoadOptionsTest){
+    COpenStreetMap::SLoadOptions Options;
+    Options.DTagKeys = {"highway", "name"};
+    Options.DWayFilter = IsHighway;
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(FilterData)), Options);
+
+    ASSERT_EQ(StreetMap.NodeCount(), 4);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->AttributeCount(), 0);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->AttributeCount(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->GetAttribute("highway"), "traffic_signals");
+    ASSERT_EQ(StreetMap.WayCount(), 2);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->ID(), 10);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->AttributeCount(), 2);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->GetAttribute("name"), "A Street");
+    EXPECT_FALSE(StreetMap.WayByIndex(0)->HasAttribute("version"));
+    EXPECT_EQ(StreetMap.WayByIndex(1)->ID(), 11);
+    EXPECT_EQ(StreetMap.WayByID(12), nullptr);
+}
+
+TEST(OpenStreetMap, LoadBoundsTest){
+    COpenStreetMap::SLoadOptions Options;
+    Options.DUseBounds = true;
+    Options.DLowerLeft = {38.4, -121.7};
+    Options.DUpperRight = {38.7, -121.4};
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(FilterData)), Options);
+
+    ASSERT_EQ(StreetMap.NodeCount(), 2);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->ID(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->GetAttribute("version"), "2");
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->ID(), 2);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->AttributeCount(), 2);
+    // way 11 lies entirely outside the box
+    ASSERT_EQ(StreetMap.WayCount(), 2);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->ID(), 10);
+    EXPECT_EQ(StreetMap.WayByIndex(1)->ID(), 12);
+}
+
+TEST(OpenStreetMap, LoadReferencedNodesTest){
+    COpenStreetMap::SLoadOptions Options;
+    Options.DTagKeys = {"highway"};
+    Options.DWayFilter = IsHighway;
+    Options.DUseBounds = true;
+    Options.DLowerLeft = {38.4, -121.7};
+    Options.DUpperRight = {38.7, -121.4};
+    Options.DReferencedNodesOnly = true;
+    SLoadStats Stats;
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(FilterData)), Options, &Stats);
+
+    // node 3 is outside the box but way 10 references it, node 2 is inside but only the building uses it
+    ASSERT_EQ(StreetMap.NodeCount(), 2);
+    EXPECT_EQ(StreetMap.NodeByIndex(0)->ID(), 1);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->ID(), 3);
+    EXPECT_EQ(StreetMap.NodeByIndex(1)->Location(), std::make_pair(38.9, -121.9));
+    ASSERT_EQ(StreetMap.WayCount(), 1);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->GetNodeID(1), 3);
+    EXPECT_EQ(Stats.DNodeCount, 2);
+    EXPECT_EQ(Stats.DWayCount, 1);
+}
+
+TEST(OpenStreetMap, SpatialOrderTest){
+    COpenStreetMap::SLoadOptions Options;
+    Options.DSpatialOrder = true;
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(FilterData)), Options);
+
+    ASSERT_EQ(StreetMap.NodeCount(), 4);
+    ASSERT_EQ(StreetMap.WayCount(), 3);
+    for(std::size_t Index = 1; Index < StreetMap.NodeCount(); Index++){
+        EXPECT_LT(GeographicUtils::HilbertIndex(GeographicUtils::ToFixed(StreetMap.NodeByIndex(Index - 1)->Location())),
+                  GeographicUtils::HilbertIndex(GeographicUtils::ToFixed(StreetMap.NodeByIndex(Index)->Location())));
+    }
+    // ids still find their elements wherever they moved
+    EXPECT_EQ(StreetMap.NodeByID(2)->GetAttribute("source"), "survey");
+    EXPECT_EQ(StreetMap.NodeByID(1)->GetAttribute("version"), "2");
+    EXPECT_EQ(StreetMap.NodeByID(4)->Location(), std::make_pair(38.1, -121.1));
+    EXPECT_EQ(StreetMap.WayByID(10)->GetAttribute("name"), "A Street");
+    EXPECT_EQ(StreetMap.WayByID(11)->GetNodeID(1), 4);
+    // ways follow the curve at the mean of their node locations
+    auto WayKey = [&](std::size_t index){
+        auto Way = StreetMap.WayByIndex(index);
+        double Latitude = 0.0, Longitude = 0.0;
+        for(std::size_t NodeIndex = 0; NodeIndex < Way->NodeCount(); NodeIndex++){
+            Latitude += StreetMap.NodeByID(Way->GetNodeID(NodeIndex))->Location().first / Way->NodeCount();
+            Longitude += StreetMap.NodeByID(Way->GetNodeID(NodeIndex))->Location().second / Way->NodeCount();
+        }
+        return GeographicUtils::HilbertIndex(GeographicUtils::ToFixed({Latitude, Longitude}));
+    };
+    EXPECT_LT(WayKey(0), WayKey(1));
+    EXPECT_LT(WayKey(1), WayKey(2));
+    std::size_t Index;
+    CStreetMap::TWayID ID = 12;
+    StreetMap.WayIndicesByID(&ID, 1, &Index);
+    EXPECT_EQ(StreetMap.WayByIndex(Index)->ID(), 12);
+}
+
+TEST(OpenStreetMap, SpatialOrderReferencedNodesTest){
+    COpenStreetMap::SLoadOptions Options;
+    Options.DTagKeys = {"highway"};
+    Options.DWayFilter = IsHighway;
+    Options.DReferencedNodesOnly = true;
+    Options.DSpatialOrder = true;
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(FilterData)), Options);
+
+    // nodes 1, 3 and 4 are on highways
+    ASSERT_EQ(StreetMap.NodeCount(), 3);
+    for(std::size_t Index = 1; Index < StreetMap.NodeCount(); Index++){
+        EXPECT_LT(GeographicUtils::HilbertIndex(GeographicUtils::ToFixed(StreetMap.NodeByIndex(Index - 1)->Location())),
+                  GeographicUtils::HilbertIndex(GeographicUtils::ToFixed(StreetMap.NodeByIndex(Index)->Location())));
+    }
+    EXPECT_EQ(StreetMap.NodeByID(2), nullptr);
+    EXPECT_EQ(StreetMap.NodeByID(1)->AttributeCount(), 0);
+    EXPECT_EQ(StreetMap.WayCount(), 2);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "StopDistanceMatrix.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+static std::shared_ptr<CStreetMap> CreateMap(const std::string &oneway){
+    auto Source = std::make_shared<CStringDataSource>(
+        "<?xml version='1.0' encoding='UTF-8'?>"
+        "<osm version=\"0.6\">"
+        "<node id=\"1\" lat=\"38.5\" lon=\"-121.700\"/>"
+        "<node id=\"2\" lat=\"38.5\" lon=\"-121.701\"/>"
+        "<node id=\"3\" lat=\"38.5\" lon=\"-121.702\"/>"
+        "<node id=\"4\" lat=\"38.6\" lon=\"-121.702\"/>"
+        "<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><nd ref=\"3\"/>"
+        "<tag k=\"highway\" v=\"residential\"/>" + oneway + "</way>"
+        "<way id=\"11\"><nd ref=\"3\"/><nd ref=\"4\"/><tag k=\"building\" v=\"yes\"/></way>"
+        "</osm>");
+    return std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(Source));
+}
+
+static std::shared_ptr<CBusSystem> CreateBusSystem(){
+    auto StopSource = std::make_shared<CStringDataSource>("100,1\n101,3\n102,4\n");
+    auto RouteSource = std::make_shared<CStringDataSource>("A,100\nA,101\n");
+    return std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(StopSource, ','), std::make_shared<CDSVReader>(RouteSource, ','));
+}
+
+TEST(StopDistanceMatrix, TwoWayTest){
+    CStopDistanceMatrix Matrix(CreateMap(""), CreateBusSystem());
+
+    ASSERT_EQ(Matrix.StopCount(), 3);
+    EXPECT_EQ(Matrix.StopID(0), 100);
+    EXPECT_TRUE(Matrix.StopID(3) == CBusSystem::InvalidStopID);
+    EXPECT_EQ(Matrix.Distance(0, 1), CStopDistanceMatrix::NoPathDistance);
+    EXPECT_TRUE(Matrix.Compute(2));
+    EXPECT_EQ(Matrix.Distance(0, 0), 0.0);
+    EXPECT_NEAR(Matrix.DistanceByID(100, 101), 174.0, 1.0);
+    EXPECT_NEAR(Matrix.DistanceByID(101, 100), 174.0, 1.0);
+    EXPECT_EQ(Matrix.DistanceByID(100, 102), CStopDistanceMatrix::NoPathDistance);
+    EXPECT_EQ(Matrix.DistanceByID(102, 102), 0.0);
+    EXPECT_EQ(Matrix.DistanceByID(100, 999), CStopDistanceMatrix::NoPathDistance);
+}
+
+TEST(StopDistanceMatrix, OneWayTest){
+    CStopDistanceMatrix Matrix(CreateMap("<tag k=\"oneway\" v=\"yes\"/>"), CreateBusSystem());
+
+    EXPECT_TRUE(Matrix.Compute(1));
+    EXPECT_NEAR(Matrix.DistanceByID(100, 101), 174.0, 1.0);
+    EXPECT_EQ(Matrix.DistanceByID(101, 100), CStopDistanceMatrix::NoPathDistance);
+}
+
+TEST(StopDistanceMatrix, WriteTest){
+    CStopDistanceMatrix Matrix(CreateMap("<tag k=\"oneway\" v=\"yes\"/>"), CreateBusSystem());
+    auto Sink = std::make_shared<CStringDataSink>();
+
+    EXPECT_FALSE(Matrix.Write(std::make_shared<CDSVWriter>(Sink, ',')));
+    EXPECT_TRUE(Matrix.Compute());
+    EXPECT_TRUE(Matrix.Write(std::make_shared<CDSVWriter>(Sink, ',')));
+    EXPECT_EQ(Sink->String(),
+        "stop_id,100,101,102\n"
+        "100,0.0,174.0,\n"
+        "101,,0.0,\n"
+        "102,,,0.0\n");
+}
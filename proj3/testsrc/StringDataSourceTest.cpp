@@ -81,3 +81,24 @@ TEST(StringDataSource, ReadTest){
     EXPECT_FALSE(Source2.Peek(TempCh));
     EXPECT_EQ(TempCh,'x');
 }
+
+TEST(StringDataSource, SeekTest){
+    CStringDataSource Source("Hello World");
+    std::vector<char> TempVector;
+    char TempCh;
+
+    EXPECT_EQ(Source.Size(), 11);
+    EXPECT_EQ(Source.Tell(), 0);
+    EXPECT_TRUE(Source.Seek(6));
+    EXPECT_EQ(Source.Tell(), 6);
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh,'W');
+    EXPECT_TRUE(Source.Seek(0));
+    EXPECT_TRUE(Source.Read(TempVector, 5));
+    EXPECT_EQ(std::string(TempVector.begin(), TempVector.end()), "Hello");
+    EXPECT_EQ(Source.Tell(), 5);
+    EXPECT_TRUE(Source.Seek(11));
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Seek(12));
+    EXPECT_EQ(Source.Tell(), 11);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "StringUtils.h"
+#include <algorithm>
+#include <cstdlib>
 
 TEST(StringUtilsTest, SliceTest){
     EXPECT_EQ("me", StringUtils::Slice("meow", 0, 2));
@@ -20,6 +22,26 @@ TEST(StringUtilsTest, Lower){
     EXPECT_EQ("meow", StringUtils::Lower("MEOW"));
 }
 
+TEST(StringUtilsTest, CaseLongAndNonAscii){
+    std::string Mixed = "Russell Blvd @ [Anderson_Rd] {Z} caf\xc3\xa9 \xc3\x89" "COLE 0123456789 `az`";
+
+    EXPECT_EQ("RUSSELL BLVD @ [ANDERSON_RD] {Z} CAF\xc3\xa9 \xc3\x89" "COLE 0123456789 `AZ`", StringUtils::Upper(Mixed));
+    EXPECT_EQ("russell blvd @ [anderson_rd] {z} caf\xc3\xa9 \xc3\x89" "cole 0123456789 `az`", StringUtils::Lower(Mixed));
+    EXPECT_EQ("Russell blvd @ [anderson_rd] {z} caf\xc3\xa9 \xc3\x89" "cole 0123456789 `az`", StringUtils::Capitalize(Mixed));
+    for(int Ch = 0; Ch < 256; Ch++){
+        std::string Block(33, char(Ch));
+        EXPECT_EQ(std::string(33, char(toupper(Ch))), StringUtils::Upper(Block));
+        EXPECT_EQ(std::string(33, char(tolower(Ch))), StringUtils::Lower(Block));
+    }
+}
+
+TEST(StringUtilsTest, CaseLocale){
+    EXPECT_EQ("MEOW", StringUtils::Upper("meow", std::locale::classic()));
+    EXPECT_EQ("meow", StringUtils::Lower("MEOW", std::locale::classic()));
+    EXPECT_EQ("Meow", StringUtils::Capitalize("mEOW", std::locale::classic()));
+    EXPECT_EQ("", StringUtils::Capitalize("", std::locale::classic()));
+}
+
 TEST(StringUtilsTest, LStrip){
     EXPECT_EQ("meow", StringUtils::LStrip("   meow"));
 }
@@ -30,6 +52,11 @@ TEST(StringUtilsTest, RStrip){
 
 TEST(StringUtilsTest, Strip){
     EXPECT_EQ("meow", StringUtils::Strip("       meow     "));
+    EXPECT_EQ("me ow", StringUtils::Strip("\t\n\v\f\r me ow \r\n"));
+    EXPECT_EQ("x", StringUtils::Strip(std::string(40, '\t') + "x" + std::string(40, ' ')));
+    EXPECT_EQ("a" + std::string(20, ' ') + "b", StringUtils::Strip(std::string(17, '\n') + "a" + std::string(20, ' ') + "b" + std::string(33, '\r')));
+    EXPECT_EQ("", StringUtils::Strip(std::string(50, ' ')));
+    EXPECT_EQ("\x85meow\x1f", StringUtils::Strip(" \x85meow\x1f "));
 }
 
 TEST(StringUtilsTest, Center){
@@ -46,10 +73,16 @@ TEST(StringUtilsTest, RJust){
 
 TEST(StringUtilsTest, Replace){
     EXPECT_EQ("meowmeowmeowmeowmeow", StringUtils::Replace("meowlalameowlalameow", "lala", "meow"));
+    EXPECT_EQ("aaaa", StringUtils::Replace("aa", "a", "aa"));
+    EXPECT_EQ("-m-e-", StringUtils::Replace("me", "", "-"));
 }
 
 TEST(StringUtilsTest, Split){
-    // EXPECT_EQ({"meow", "meow", "meow"}, StringUtils::Split("meow/meow/meow", "/"));
+    EXPECT_EQ(std::vector< std::string >({"meow", "meow", "meow"}), StringUtils::Split("meow/meow/meow", "/"));
+    EXPECT_EQ(std::vector< std::string >({"", "meow", ""}), StringUtils::Split("//meow//", "//"));
+    EXPECT_EQ(std::vector< std::string >({""}), StringUtils::Split("", ","));
+    EXPECT_EQ(std::vector< std::string >({"meow", "purr"}), StringUtils::Split("  meow \t\n purr "));
+    EXPECT_TRUE(StringUtils::Split("   ").empty());
 }
 
 TEST(StringUtilsTest, Join){
@@ -57,9 +90,176 @@ TEST(StringUtilsTest, Join){
 }
 
 TEST(StringUtilsTest, ExpandTabs){
-    
+    EXPECT_EQ("me  ow", StringUtils::ExpandTabs("me\tow"));
+    EXPECT_EQ("me      ow", StringUtils::ExpandTabs("me\tow", 8));
+    EXPECT_EQ("meow", StringUtils::ExpandTabs("me\tow", 0));
+}
+
+// plain full table distance the optimized versions are checked against
+static int ReferenceEditDistance(const std::string &left, const std::string &right){
+    std::vector< std::vector< int > > Table(left.size() + 1, std::vector< int >(right.size() + 1));
+    for(size_t i = 0; i <= left.size(); i++){
+        Table[i][0] = i;
+    }
+    for(size_t j = 0; j <= right.size(); j++){
+        Table[0][j] = j;
+    }
+    for(size_t i = 1; i <= left.size(); i++){
+        for(size_t j = 1; j <= right.size(); j++){
+            int Cost = left[i - 1] == right[j - 1] ? 0 : 1;
+            Table[i][j] = std::min(std::min(Table[i - 1][j] + 1, Table[i][j - 1] + 1), Table[i - 1][j - 1] + Cost);
+        }
+    }
+    return Table[left.size()][right.size()];
 }
 
 TEST(StringUtilsTest, EditDistance){
-    
+    EXPECT_EQ(0, StringUtils::EditDistance("", ""));
+    EXPECT_EQ(4, StringUtils::EditDistance("meow", ""));
+    EXPECT_EQ(4, StringUtils::EditDistance("", "meow"));
+    EXPECT_EQ(3, StringUtils::EditDistance("kitten", "sitting"));
+    EXPECT_EQ(4, StringUtils::EditDistance("MEOW", "meow"));
+    EXPECT_EQ(0, StringUtils::EditDistance("MEOW", "meow", true));
+    EXPECT_EQ(1, StringUtils::EditDistance("Russell Blvd", "russel blvd", true));
+}
+
+TEST(StringUtilsTest, EditDistanceMaxDistance){
+    EXPECT_EQ(3, StringUtils::EditDistance("kitten", "sitting", false, 3));
+    EXPECT_EQ(3, StringUtils::EditDistance("kitten", "sitting", false, 2));
+    EXPECT_EQ(2, StringUtils::EditDistance("kitten", "sitting", false, 1));
+    EXPECT_EQ(1, StringUtils::EditDistance("kitten", "sitting", false, 0));
+    EXPECT_EQ(6, StringUtils::EditDistance("a", "abcdefghij", false, 5));
+    EXPECT_EQ(0, StringUtils::EditDistance("same", "same", false, 0));
+}
+
+TEST(StringUtilsTest, EditDistanceRandom){
+    std::srand(34);
+    const std::string Alphabet = "abcAB ";
+    for(int Trial = 0; Trial < 400; Trial++){
+        std::string Left, Right;
+        size_t LeftSize = std::rand() % (Trial < 200 ? 20 : 150);
+        size_t RightSize = std::rand() % (Trial < 200 ? 20 : 150);
+        for(size_t i = 0; i < LeftSize; i++){
+            Left += Alphabet[std::rand() % Alphabet.size()];
+        }
+        for(size_t i = 0; i < RightSize; i++){
+            Right += Alphabet[std::rand() % Alphabet.size()];
+        }
+        int Expected = ReferenceEditDistance(Left, Right);
+        int Limit = std::rand() % 40;
+        EXPECT_EQ(Expected, StringUtils::EditDistance(Left, Right));
+        EXPECT_EQ(ReferenceEditDistance(StringUtils::Lower(Left), StringUtils::Lower(Right)), StringUtils::EditDistance(Left, Right, true));
+        EXPECT_EQ(std::min(Expected, Limit + 1), StringUtils::EditDistance(Left, Right, false, Limit));
+    }
+}
+
+TEST(StringUtilsTest, ViewFunctions){
+    std::string_view Text = "  meow  ";
+
+    EXPECT_EQ("meow  ", StringUtils::LStripView(Text));
+    EXPECT_EQ("  meow", StringUtils::RStripView(Text));
+    EXPECT_EQ("meow", StringUtils::StripView(Text));
+    EXPECT_EQ("", StringUtils::StripView("    "));
+    EXPECT_EQ("", StringUtils::StripView(""));
+    EXPECT_EQ(Text.data() + 2, StringUtils::StripView(Text).data());
+    EXPECT_EQ("eow", StringUtils::SliceView("meow", 1));
+    EXPECT_EQ("eo", StringUtils::SliceView("meow", -3, -1));
+    EXPECT_EQ("", StringUtils::SliceView("meow", 3, 1));
+    EXPECT_EQ("", StringUtils::SliceView("meow", 10));
+    EXPECT_EQ("meow", StringUtils::SliceView("meow", -10));
+}
+
+TEST(StringUtilsTest, AppendFunctions){
+    std::string Out = "[";
+
+    StringUtils::UpperTo(Out, "meow");
+    StringUtils::LowerTo(Out, "PURR");
+    StringUtils::CapitalizeTo(Out, "hISS");
+    StringUtils::CapitalizeTo(Out, "");
+    EXPECT_EQ("[MEOWpurrHiss", Out);
+    Out.clear();
+    StringUtils::CenterTo(Out, "meow", 9, '*');
+    StringUtils::LJustTo(Out, "ab", 3, '-');
+    StringUtils::RJustTo(Out, "ab", 3, '-');
+    StringUtils::RJustTo(Out, "meow", 2);
+    EXPECT_EQ("**meow***ab--abmeow", Out);
+    Out.clear();
+    StringUtils::ReplaceTo(Out, "a.b.c", ".", "::");
+    StringUtils::JoinTo(Out, ",", {});
+    StringUtils::JoinTo(Out, ",", {"x", "y"});
+    StringUtils::ExpandTabsTo(Out, "\t!", 2);
+    EXPECT_EQ("a::b::cx,y  !", Out);
+}
+
+TEST(StringUtilsTest, SplitView){
+    std::vector< std::string_view > Pieces;
+    std::string Text = "a,,b,";
+
+    for(auto Piece : StringUtils::SplitView(Text, ",")){
+        Pieces.push_back(Piece);
+    }
+    ASSERT_EQ(Pieces.size(), 4);
+    EXPECT_EQ("a", Pieces[0]);
+    EXPECT_EQ("", Pieces[1]);
+    EXPECT_EQ("b", Pieces[2]);
+    EXPECT_EQ("", Pieces[3]);
+    EXPECT_EQ(Text.data() + 3, Pieces[2].data());
+
+    auto View = StringUtils::SplitView(" one  two ");
+    auto Iterator = View.begin();
+    EXPECT_EQ("one", *Iterator++);
+    EXPECT_EQ("two", *Iterator);
+    EXPECT_TRUE(++Iterator == View.end());
+    auto EmptyView = StringUtils::SplitView("");
+    EXPECT_TRUE(EmptyView.begin() == EmptyView.end());
+}
+
+TEST(StringUtilsTest, PatternFind){
+    StringUtils::CPattern Pattern("lala");
+
+    EXPECT_EQ("lala", Pattern.Pattern());
+    EXPECT_EQ(4, Pattern.Find("meowlalameow"));
+    EXPECT_EQ(std::string_view::npos, Pattern.Find("meowlalameow", 5));
+    EXPECT_EQ(std::string_view::npos, Pattern.Find("lal"));
+    EXPECT_EQ(std::string_view::npos, Pattern.Find("lala", 10));
+    EXPECT_EQ(3, StringUtils::CPattern("").Find("meow", 3));
+    EXPECT_EQ(2, Pattern.Count("lalalalala"));
+    EXPECT_EQ(5, StringUtils::CPattern("").Count("meow"));
+
+    std::srand(33);
+    for(int Trial = 0; Trial < 300; Trial++){
+        std::string Text, Needle;
+        size_t TextSize = std::rand() % 400;
+        size_t NeedleSize = 1 + std::rand() % (Trial % 3 ? 5 : 48);
+        for(size_t i = 0; i < TextSize; i++){
+            Text += "ab"[std::rand() % 2];
+        }
+        for(size_t i = 0; i < NeedleSize; i++){
+            Needle += "ab"[std::rand() % 2];
+        }
+        StringUtils::CPattern Compiled(Needle);
+        for(size_t Position = 0; Position <= Text.size(); Position += 1 + std::rand() % 50){
+            EXPECT_EQ(Text.find(Needle, Position), Compiled.Find(Text, Position));
+        }
+    }
+}
+
+TEST(StringUtilsTest, PatternReplaceSplit){
+    StringUtils::CPattern Pattern("lala");
+    std::string Long;
+    std::string Expected;
+    for(int Index = 0; Index < 100; Index++){
+        Long += "meowlala";
+        Expected += "meow--";
+    }
+
+    EXPECT_EQ("meowmeowmeowmeow", Pattern.Replace("lalameowlalameow", "meow"));
+    EXPECT_EQ(Expected, Pattern.Replace(Long, "--"));
+    EXPECT_EQ(Expected, StringUtils::Replace(Long, "lala", "--"));
+    EXPECT_EQ(std::vector< std::string >({"a", "", "b"}), StringUtils::CPattern(", ").Split("a, , b"));
+    EXPECT_EQ(std::vector< std::string >({"a", "b"}), StringUtils::CPattern("").Split(" a  b "));
+    auto Pieces = StringUtils::Split(Long, "lala");
+    ASSERT_EQ(Pieces.size(), 101);
+    EXPECT_EQ("meow", Pieces[99]);
+    EXPECT_EQ("", Pieces[100]);
 }
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "SyntheticMapGenerator.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <unordered_set>
+
+TEST(SyntheticMapGenerator, MapTest){
+    CSyntheticMapGenerator Generator(2000, 7);
+    auto Sink = std::make_shared<CStringDataSink>();
+
+    ASSERT_TRUE(Generator.WriteOSM(Sink));
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(Sink->String())));
+    ASSERT_EQ(StreetMap.NodeCount(), 2000);
+    EXPECT_EQ(StreetMap.WayCount(), Generator.WayCount());
+    EXPECT_GT(Generator.WayCount(), 100);
+
+    std::unordered_set< CStreetMap::TNodeID > NodeIDs;
+    for(std::size_t Index = 0; Index < StreetMap.NodeCount(); Index++){
+        EXPECT_EQ(StreetMap.NodeByIndex(Index)->ID(), Generator.NodeID(Index));
+        if(Index){
+            EXPECT_LT(Generator.NodeID(Index - 1), Generator.NodeID(Index));
+        }
+        NodeIDs.insert(Generator.NodeID(Index));
+    }
+    std::size_t Named = 0;
+    for(std::size_t Index = 0; Index < StreetMap.WayCount(); Index++){
+        auto Way = StreetMap.WayByIndex(Index);
+        EXPECT_GE(Way->NodeCount(), 2);
+        EXPECT_TRUE(Way->HasAttribute("highway"));
+        Named += Way->HasAttribute("name");
+        for(std::size_t NodeIndex = 0; NodeIndex < Way->NodeCount(); NodeIndex++){
+            EXPECT_EQ(NodeIDs.count(Way->GetNodeID(NodeIndex)), 1);
+        }
+    }
+    EXPECT_GT(Named, Generator.WayCount() / 2);
+    EXPECT_TRUE(Generator.NodeID(2000) == CStreetMap::InvalidNodeID);
+}
+
+TEST(SyntheticMapGenerator, DeterministicTest){
+    auto First = std::make_shared<CStringDataSink>();
+    auto Second = std::make_shared<CStringDataSink>();
+
+    EXPECT_TRUE(CSyntheticMapGenerator(300, 3).WriteOSM(First));
+    EXPECT_TRUE(CSyntheticMapGenerator(300, 3).WriteOSM(Second));
+    EXPECT_EQ(First->String(), Second->String());
+}
+
+TEST(SyntheticMapGenerator, TransitTest){
+    CSyntheticMapGenerator Generator(20000, 5);
+    auto StopSink = std::make_shared<CStringDataSink>();
+    auto RouteSink = std::make_shared<CStringDataSink>();
+
+    ASSERT_TRUE(Generator.WriteStops(StopSink));
+    ASSERT_TRUE(Generator.WriteRoutes(RouteSink));
+    EXPECT_EQ(StopSink->String().substr(0, 16), "stop_id,node_id\n");
+    EXPECT_EQ(RouteSink->String().substr(0, 14), "route,stop_id\n");
+
+    CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(StopSink->String()), ','),
+                            std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(RouteSink->String()), ','));
+    ASSERT_EQ(BusSystem.StopCount(), Generator.StopCount());
+    ASSERT_EQ(BusSystem.RouteCount(), Generator.RouteCount());
+    for(std::size_t Index = 0; Index < BusSystem.StopCount(); Index++){
+        EXPECT_GE(BusSystem.NodeStopCount(BusSystem.StopByIndex(Index)->NodeID()), 1);
+    }
+    for(std::size_t Index = 0; Index < BusSystem.RouteCount(); Index++){
+        auto Route = BusSystem.RouteByIndex(Index);
+        EXPECT_GE(Route->StopCount(), 10);
+        for(std::size_t StopIndex = 0; StopIndex < Route->StopCount(); StopIndex++){
+            EXPECT_NE(BusSystem.StopByID(Route->GetStopID(StopIndex)), nullptr);
+        }
+    }
+}
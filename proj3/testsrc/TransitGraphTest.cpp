@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "TransitGraph.h"
+#include "CSVBusSystem.h"
+#include "StringDataSource.h"
+
+static std::shared_ptr<CBusSystem> CreateBusSystem(){
+    auto StopSource = std::make_shared<CStringDataSource>("1,11\n2,12\n3,13\n4,14\n5,15\n6,16\n7,17\n8,18\n9,19\n10,20\n11,21\n");
+    auto RouteSource = std::make_shared<CStringDataSource>(
+        "A,1\nA,2\nA,3\nA,4\n"
+        "B,3\nB,5\nB,6\n"
+        "C,1\nC,7\nC,8\nC,9\nC,10\nC,6\n");
+    return std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(StopSource, ','), std::make_shared<CDSVReader>(RouteSource, ','));
+}
+
+TEST(TransitGraph, StructureTest){
+    CTransitGraph Graph(CreateBusSystem());
+
+    EXPECT_EQ(Graph.StopCount(), 11);
+    EXPECT_EQ(Graph.RouteCount(), 3);
+    EXPECT_EQ(Graph.TransferStopCount(), 3);
+    EXPECT_TRUE(Graph.IsTransferStop(1));
+    EXPECT_TRUE(Graph.IsTransferStop(3));
+    EXPECT_TRUE(Graph.IsTransferStop(6));
+    EXPECT_FALSE(Graph.IsTransferStop(2));
+    EXPECT_FALSE(Graph.IsTransferStop(11));
+    EXPECT_FALSE(Graph.IsTransferStop(99));
+}
+
+TEST(TransitGraph, JourneyTest){
+    CTransitGraph Graph(CreateBusSystem());
+    std::vector< CTransitGraph::SJourney > Journeys;
+
+    ASSERT_TRUE(Graph.FindJourneys(1, 6, Journeys));
+    ASSERT_EQ(Journeys.size(), 2);
+    EXPECT_EQ(Journeys[0].Transfers(), 0);
+    EXPECT_EQ(Journeys[0].DArrival, 5.0);
+    ASSERT_EQ(Journeys[0].DLegs.size(), 1);
+    EXPECT_EQ(Journeys[0].DLegs[0].DRouteName, "C");
+    EXPECT_EQ(Journeys[0].DLegs[0].DRideStopCount, 5);
+    EXPECT_EQ(Journeys[1].Transfers(), 1);
+    EXPECT_EQ(Journeys[1].DArrival, 4.0);
+    ASSERT_EQ(Journeys[1].DLegs.size(), 2);
+    EXPECT_EQ(Journeys[1].DLegs[0].DRouteName, "A");
+    EXPECT_EQ(Journeys[1].DLegs[0].DBoardStopID, 1);
+    EXPECT_EQ(Journeys[1].DLegs[0].DAlightStopID, 3);
+    EXPECT_EQ(Journeys[1].DLegs[1].DRouteName, "B");
+    EXPECT_EQ(Journeys[1].DLegs[1].DBoardStopID, 3);
+    EXPECT_EQ(Journeys[1].DLegs[1].DAlightStopID, 6);
+
+    CTransitGraph::SJourney Journey;
+    ASSERT_TRUE(Graph.FindMinimumTransfers(1, 6, Journey));
+    EXPECT_EQ(Journey.DLegs[0].DRouteName, "C");
+    ASSERT_TRUE(Graph.FindEarliestArrival(1, 6, Journey));
+    EXPECT_EQ(Journey.DArrival, 4.0);
+    ASSERT_TRUE(Graph.FindJourneys(1, 6, Journeys, 0));
+    ASSERT_EQ(Journeys.size(), 1);
+    EXPECT_EQ(Journeys[0].Transfers(), 0);
+}
+
+TEST(TransitGraph, UnreachableTest){
+    CTransitGraph Graph(CreateBusSystem());
+    std::vector< CTransitGraph::SJourney > Journeys;
+
+    EXPECT_FALSE(Graph.FindJourneys(4, 1, Journeys));
+    EXPECT_TRUE(Journeys.empty());
+    EXPECT_FALSE(Graph.FindJourneys(1, 11, Journeys));
+    EXPECT_FALSE(Graph.FindJourneys(1, 99, Journeys));
+    ASSERT_TRUE(Graph.FindJourneys(5, 5, Journeys));
+    EXPECT_TRUE(Journeys[0].DLegs.empty());
+}
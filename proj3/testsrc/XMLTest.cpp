@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "XMLReader.h"
+#include "StringDataSource.h"
+
+TEST(XMLReader, SkipElementTest){
+    CXMLReader Reader(std::make_shared<CStringDataSource>("<osm><node id=\"1\"><tag k=\"a\"/><tag k=\"b\">text</tag></node><way id=\"2\"/></osm>"));
+    SXMLEntity Entity;
+
+    // nothing is open yet
+    EXPECT_FALSE(Reader.SkipElement());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "osm");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "node");
+    ASSERT_TRUE(Reader.SkipElement());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "way");
+    EXPECT_EQ(Entity.AttributeValue("id"), "2");
+    // a self closing element is skipped through its own end
+    ASSERT_TRUE(Reader.SkipElement());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "osm");
+    EXPECT_FALSE(Reader.SkipElement());
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
+}
+
+TEST(XMLReader, SkipNestedElementTest){
+    CXMLReader Reader(std::make_shared<CStringDataSource>("<a><b><c><d/></c><e/></b><f/></a>"));
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "c");
+    // only the innermost open element is skipped, its parent continues
+    ASSERT_TRUE(Reader.SkipElement());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "e");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "e");
+    ASSERT_TRUE(Reader.SkipElement());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "f");
+}
+
+TEST(XMLReader, SkipLargeElementTest){
+    std::string Data = "<osm><node id=\"1\">";
+    for (int Index = 0; Index < 1000; Index++) {
+        Data += "<tag k=\"key\" v=\"value\">some text</tag>";
+    }
+    Data += "tail</node><node id=\"2\">kept</node></osm>";
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Data));
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_TRUE(Reader.SkipElement());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "node");
+    EXPECT_EQ(Entity.AttributeValue("id"), "2");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameData, "kept");
+}
+
+TEST(XMLReader, SkipUnterminatedElementTest){
+    CXMLReader Reader(std::make_shared<CStringDataSource>("<osm><node id=\"1\"><tag k=\"a\"/>"));
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_FALSE(Reader.SkipElement());
+    EXPECT_TRUE(Reader.End());
+}
@@ -0,0 +1,76 @@
+#include "OSMFilter.h"
+#include "FileDataSource.h"
+#include "FileDataSink.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+static void Usage(const char *program){
+    std::cerr << "usage: " << program << " input.osm output.osm [options]\n"
+              << "  -b minlat,minlon,maxlat,maxlon  keep nodes inside and ways touching the box\n"
+              << "  -w key[=value]                  keep ways with the tag, repeatable, value defaults to *\n"
+              << "  -n key[=value]                  keep nodes with the tag, repeatable\n"
+              << "  -c                              read the input twice to add every node a kept way references\n"
+              << "  -r                              with -c, write only referenced nodes\n";
+}
+
+static std::shared_ptr<CXMLReader> OpenInput(const std::string &filename){
+    auto Source = std::make_shared<CFileDataSource>(filename);
+    return Source->IsOpen() ? std::make_shared<CXMLReader>(Source) : nullptr;
+}
+
+// streams an osm extract through COSMFilter with bounded memory
+int main(int argc, char *argv[]){
+    if(argc < 3){
+        Usage(argv[0]);
+        return 1;
+    }
+    std::string Input = argv[1];
+    COSMFilter Filter;
+    bool Closure = false;
+    for(int Index = 3; Index < argc; Index++){
+        std::string Option = argv[Index];
+        if(Option == "-c"){
+            Closure = true;
+        }
+        else if(Option == "-r"){
+            Filter.SetReferencedNodesOnly(true);
+        }
+        else if(Index + 1 < argc && Option == "-b"){
+            double MinLat, MinLon, MaxLat, MaxLon;
+            if(std::sscanf(argv[++Index], "%lf,%lf,%lf,%lf", &MinLat, &MinLon, &MaxLat, &MaxLon) != 4){
+                Usage(argv[0]);
+                return 1;
+            }
+            Filter.SetBoundingBox({MinLat, MinLon}, {MaxLat, MaxLon});
+        }
+        else if(Index + 1 < argc && (Option == "-w" || Option == "-n")){
+            std::string Tag = argv[++Index];
+            std::size_t Equals = Tag.find('=');
+            auto Element = Option == "-w" ? COSMFilter::EElement::Way : COSMFilter::EElement::Node;
+            Filter.AddTagFilter(Element, Tag.substr(0, Equals), Equals == std::string::npos ? "*" : Tag.substr(Equals + 1));
+        }
+        else{
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    auto Sink = std::make_shared<CFileDataSink>(argv[2]);
+    auto Source = OpenInput(Input);
+    auto Scan = Closure ? OpenInput(Input) : nullptr;
+    if(!Sink->IsOpen() || !Source || (Closure && !Scan)){
+        std::cerr << "unable to open " << (Sink->IsOpen() ? Input : std::string(argv[2])) << "\n";
+        return 1;
+    }
+    std::string Declaration = "<?xml version='1.0' encoding='UTF-8'?>\n";
+    auto Writer = std::make_shared<CXMLWriter>(Sink);
+    bool Success = Sink->Write(std::vector<char>(Declaration.begin(), Declaration.end()));
+    Success = Success && (Closure ? Filter.Filter(Scan, Source, Writer) : Filter.Filter(Source, Writer));
+    if(!Success || !Sink->Put('\n') || !Sink->Flush()){
+        std::cerr << "failed filtering " << Input << "\n";
+        return 1;
+    }
+    std::cout << Filter.KeptNodeCount() << " nodes, " << Filter.KeptWayCount() << " ways\n";
+    return 0;
+}
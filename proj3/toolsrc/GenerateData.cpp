@@ -0,0 +1,53 @@
+#include "SyntheticMapGenerator.h"
+#include "FileDataSink.h"
+#include "NumberUtils.h"
+#include <iostream>
+#include <string>
+
+static void Usage(const char *program){
+    std::cerr << "usage: " << program << " directory nodecount [seed [stopcount [routecount]]]\n";
+}
+
+// writes <directory>/map.osm, <directory>/stops.csv and <directory>/routes.csv for a synthetic city
+int main(int argc, char *argv[]){
+    // unset trailing arguments keep their defaults
+    uint64_t Numbers[4] = {0, 1, 0, 0};
+    if(argc < 3 || argc > 6){
+        Usage(argv[0]);
+        return 1;
+    }
+    for(int Index = 2; Index < argc; Index++){
+        if(!NumberUtils::ToUInt64(argv[Index], Numbers[Index - 2])){
+            std::cerr << "invalid number " << argv[Index] << "\n";
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if(!Numbers[0]){
+        std::cerr << "nodecount must be positive\n";
+        Usage(argv[0]);
+        return 1;
+    }
+    std::string Directory = argv[1];
+    std::size_t NodeCount = Numbers[0];
+    uint64_t Seed = Numbers[1];
+    std::size_t StopCount = Numbers[2];
+    std::size_t RouteCount = Numbers[3];
+
+    CSyntheticMapGenerator Generator(NodeCount, Seed, StopCount, RouteCount);
+    auto MapSink = std::make_shared<CFileDataSink>(Directory + "/map.osm");
+    auto StopSink = std::make_shared<CFileDataSink>(Directory + "/stops.csv");
+    auto RouteSink = std::make_shared<CFileDataSink>(Directory + "/routes.csv");
+    if(!MapSink->IsOpen() || !StopSink->IsOpen() || !RouteSink->IsOpen()){
+        std::cerr << "unable to create output files in " << Directory << "\n";
+        return 1;
+    }
+    if(!Generator.WriteOSM(MapSink) || !Generator.WriteStops(StopSink) || !Generator.WriteRoutes(RouteSink)
+        || !MapSink->Flush() || !StopSink->Flush() || !RouteSink->Flush()){
+        std::cerr << "failed writing output\n";
+        return 1;
+    }
+    std::cout << Generator.NodeCount() << " nodes, " << Generator.WayCount() << " ways, "
+              << Generator.StopCount() << " stops, " << Generator.RouteCount() << " routes\n";
+    return 0;
+}